@@ -33,6 +33,8 @@
 #include "lexer.hpp"
 #include "grammar.hpp"
 #include "parser.hpp"
+#include "push_parser.hpp"
+#include "glr_parser.hpp"
 
 namespace neam
 {
@@ -0,0 +1,217 @@
+//
+// file : arena.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2110390681181025418_1046822183__ARENA_HPP__
+# define __N_2110390681181025418_1046822183__ARENA_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      /// \brief A monotonic (bump-pointer) allocator, made of chained blocks of memory.
+      /// Memory is never freed individually: the whole arena is reset at once (by the parser context, before each parse).
+      /// Blocks are kept between resets, so once the arena is warm, allocating is just moving a pointer.
+      ///
+      /// Attributes can ask for the arena of the current parse by having an `arena &` as first parameter:
+      /// \code static node *attr_add(neam::ct::alphyn::arena &a, node *left, const token_type &, node *right) { return a.make<add_node>(left, right); } \endcode
+      class arena
+      {
+        public:
+          static constexpr size_t default_block_size = 16 * 1024;
+
+          explicit arena(size_t _block_size = default_block_size) : block_size(_block_size) {}
+          arena(const arena &) = delete;
+          arena &operator = (const arena &) = delete;
+
+          arena(arena &&o) noexcept
+            : block_size(o.block_size), first(o.first), current(o.current), current_ptr(o.current_ptr), current_end(o.current_end), destructors(o.destructors)
+          {
+            o.first = o.current = nullptr;
+            o.current_ptr = o.current_end = nullptr;
+            o.destructors = nullptr;
+          }
+
+          ~arena()
+          {
+            reset();
+            while (first)
+            {
+              block_header *next = first->next;
+              ::operator delete(first);
+              first = next;
+            }
+          }
+
+          /// \brief Allocate \p size bytes of memory, aligned on \p alignment (that must be a power of 2)
+          void *allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+          {
+            // fast path
+            uintptr_t aligned = (reinterpret_cast<uintptr_t>(current_ptr) + (alignment - 1)) & ~uintptr_t(alignment - 1);
+            if (current && aligned + size <= reinterpret_cast<uintptr_t>(current_end))
+            {
+              current_ptr = reinterpret_cast<uint8_t *>(aligned + size);
+              return reinterpret_cast<void *>(aligned);
+            }
+            next_block(size + alignment);
+            return allocate(size, alignment);
+          }
+
+          /// \brief Allocate and construct an object of type T.
+          /// If T is not trivially destructible, its destructor will be called when the arena is reset
+          template<typename T, typename... Args>
+          T *make(Args &&... args)
+          {
+            void *memory = allocate(sizeof(T), alignof(T));
+            T *ret = new (memory) T(std::forward<Args>(args)...);
+            register_destructor(ret, std::is_trivially_destructible<T>());
+            return ret;
+          }
+
+          /// \brief Allocate an array of \p count (default-constructed) T
+          template<typename T>
+          T *make_array(size_t count)
+          {
+            static_assert(std::is_trivially_destructible<T>::value, "arena::make_array only supports trivially destructible types");
+            T *ret = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+            for (size_t i = 0; i < count; ++i)
+              new (ret + i) T();
+            return ret;
+          }
+
+          /// \brief Free everything that has been allocated, calling the registered destructors (in reverse order of construction).
+          /// The memory blocks are kept for future allocations. O(1) if there's no destructors to call.
+          void reset()
+          {
+            while (destructors)
+            {
+              destructor_entry *entry = destructors;
+              destructors = entry->next;
+              entry->destruct(entry->object);
+            }
+            current = first;
+            if (current)
+            {
+              current_ptr = current->data();
+              current_end = current_ptr + current->size;
+            }
+            else
+              current_ptr = current_end = nullptr;
+          }
+
+          /// \brief Return the size of a block (big allocations may use bigger blocks)
+          size_t get_block_size() const
+          {
+            return block_size;
+          }
+
+        private:
+          struct alignas(std::max_align_t) block_header
+          {
+            block_header *next;
+            size_t size;
+
+            uint8_t *data()
+            {
+              return reinterpret_cast<uint8_t *>(this + 1);
+            }
+          };
+
+          struct destructor_entry
+          {
+            void (*destruct)(void *);
+            void *object;
+            destructor_entry *next;
+          };
+
+          template<typename T>
+          static void destruct(void *object)
+          {
+            static_cast<T *>(object)->~T();
+          }
+
+          template<typename T>
+          void register_destructor(T *, std::true_type) {}
+
+          template<typename T>
+          void register_destructor(T *object, std::false_type)
+          {
+            destructor_entry *entry = static_cast<destructor_entry *>(allocate(sizeof(destructor_entry), alignof(destructor_entry)));
+            entry->destruct = &destruct<T>;
+            entry->object = object;
+            entry->next = destructors;
+            destructors = entry;
+          }
+
+          /// \brief Switch to the next block that can hold \p min_size bytes, allocating it if needed
+          void next_block(size_t min_size)
+          {
+            block_header **link = current ? &current->next : &first;
+            // skip (and keep for later) the blocks that are too small
+            while (*link && (*link)->size < min_size)
+              link = &(*link)->next;
+
+            if (!*link)
+            {
+              const size_t size = min_size > block_size ? min_size : block_size;
+              block_header *blk = static_cast<block_header *>(::operator new(sizeof(block_header) + size));
+              blk->next = nullptr;
+              blk->size = size;
+              *link = blk;
+            }
+            else if (current && *link != current->next)
+            {
+              // move the found block just after the current one, so that the skipped ones remain usable
+              block_header *blk = *link;
+              *link = blk->next;
+              blk->next = current->next;
+              current->next = blk;
+              link = &current->next;
+            }
+
+            current = *link;
+            current_ptr = current->data();
+            current_end = current_ptr + current->size;
+          }
+
+        private:
+          size_t block_size;
+          block_header *first = nullptr;
+          block_header *current = nullptr;
+          uint8_t *current_ptr = nullptr;
+          uint8_t *current_end = nullptr;
+          destructor_entry *destructors = nullptr;
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_2110390681181025418_1046822183__ARENA_HPP__*/
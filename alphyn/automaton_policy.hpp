@@ -0,0 +1,126 @@
+//
+// file : automaton_policy.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2043877163117512958_1457729318__AUTOMATON_POLICY_HPP__
+# define __N_2043877163117512958_1457729318__AUTOMATON_POLICY_HPP__
+
+#include "policy.hpp"
+
+// In this file are the policies that change how the automaton is used by the parser.
+// Like the stack policies, they are simply given to the parser:
+// \code parser<SyntaxClass, on_parse_error::throw_exception, bypass_unit_rules> \endcode
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief The kind of the unit rule policies (see get_policy)
+        struct unit_rule_policy_kind {};
+        /// \brief The kind of the default reduction policies (see get_policy)
+        struct default_reduction_policy_kind {};
+        /// \brief The kind of the conflict policies (see get_policy)
+        struct conflict_policy_kind {};
+        /// \brief The kind of the automaton policies (see get_policy)
+        struct automaton_policy_kind {};
+      } // namespace internal
+
+      /// \brief Unit rules (like sum -> prod) are reduced like any other rule (the default)
+      struct keep_unit_rules
+      {
+        using policy_kind = internal::unit_rule_policy_kind;
+        static constexpr bool bypass = false;
+      };
+
+      /// \brief Bypass the unit rules whose attribute is forward_first_attribute, when they are the only thing their state can do.
+      /// After a reduction to B, instead of going to a state that can only reduce A -> B, the parser directly does as if A
+      /// has been reduced (the value stays the same, only the type on the stack changes). That removes a reduction (and a state change)
+      /// for each token that goes through such a chain, and expression grammars are full of them.
+      /// \note As the lookahead isn't checked for the bypassed reduction, a syntax error may be detected one state later (but before
+      ///       the next token is shifted), so the parse result is the same. The stack may be in a different state when the error happens.
+      struct bypass_unit_rules
+      {
+        using policy_kind = internal::unit_rule_policy_kind;
+        static constexpr bool bypass = true;
+      };
+
+      /// \brief The states that can only reduce a single rule (and have nothing to shift) reduce it without looking at the next token (the default).
+      /// \note A syntax error is then found in the state where the bad token would have been shifted, a few reductions later.
+      ///       The parse result (the value, or the token that failed) is the same.
+      /// \see grammar_tools::has_default_reduction
+      struct default_reductions
+      {
+        using policy_kind = internal::default_reduction_policy_kind;
+        static constexpr bool enabled = true;
+      };
+
+      /// \brief Every reduction checks the next token against the follow set of the rule (the error is found in the state that reduces)
+      struct no_default_reductions
+      {
+        using policy_kind = internal::default_reduction_policy_kind;
+        static constexpr bool enabled = false;
+      };
+
+      /// \brief When a state has more than one thing to do with the next token, reduce a rule (and shift only if none can be reduced) (the default)
+      struct take_first_action
+      {
+        using policy_kind = internal::conflict_policy_kind;
+        static constexpr bool stop = false;
+      };
+
+      /// \brief Stop the parse, like on a syntax error, in a state that has more than one thing to do with the next token
+      /// (the conflicts resolved by the precedence levels don't count). The glr_parser runs a parser with this policy
+      /// while nothing forks, and takes its stack over at the first conflict.
+      /// \see grammar_tools::conflict_tokens
+      struct stop_on_conflicts
+      {
+        using policy_kind = internal::conflict_policy_kind;
+        static constexpr bool stop = true;
+      };
+
+      /// \brief Use the canonical LR(1) automaton (the default)
+      struct canonical_lr1
+      {
+        using policy_kind = internal::automaton_policy_kind;
+        template<typename GrammarTools>
+        using automaton = typename GrammarTools::lr1_automaton;
+      };
+
+      /// \brief Merge the states of the LR(1) automaton that have the same core (LALR(1)), giving a smaller automaton
+      /// (less code). The states whose merge would introduce a conflict (and the states that lead to them) are not merged.
+      /// \see parser::state_count and parser::lr1_state_count
+      struct lalr1
+      {
+        using policy_kind = internal::automaton_policy_kind;
+        template<typename GrammarTools>
+        using automaton = typename GrammarTools::lalr1_merge::automaton;
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_2043877163117512958_1457729318__AUTOMATON_POLICY_HPP__*/
@@ -92,6 +92,8 @@ namespace neam
             tok_br_close    = 7,    // ]
             tok_line_end    = 8,    // ;
             tok_affect      = 9,    // ::=
+            tok_left        = 10,   // %left
+            tok_right       = 11,   // %right
 
             // non-terminals
             start           = 100,
@@ -129,6 +131,8 @@ namespace neam
           // regular expressions & strings
           constexpr static string_t s_regexp = "regexp:";
           constexpr static string_t s_affect = "::=";
+          constexpr static string_t s_left = "%left";
+          constexpr static string_t s_right = "%right";
           constexpr static string_t re_atrribute = "\\[[a-zA-Z0-9:_<>-]+\\]";
           constexpr static string_t re_name = "[a-zA-Z0-9_-]+";
           constexpr static string_t re_terminal_sq = "'[ -&(-~]+'";     // (all ascii except controls and ')
@@ -144,6 +148,8 @@ namespace neam
             ct::alphyn::syntactic_unit<ct::alphyn::letter<'['>, token_type, token_type::generate_token_with_type<e_token_type::tok_br_open>>,
             ct::alphyn::syntactic_unit<ct::alphyn::string<s_affect>, token_type, token_type::generate_token_with_type<e_token_type::tok_affect>>,
             ct::alphyn::syntactic_unit<ct::alphyn::string<s_regexp>, token_type, token_type::generate_token_with_type<e_token_type::tok_regexp>>,
+            ct::alphyn::syntactic_unit<ct::alphyn::string<s_left>, token_type, token_type::generate_token_with_type<e_token_type::tok_left>>,
+            ct::alphyn::syntactic_unit<ct::alphyn::string<s_right>, token_type, token_type::generate_token_with_type<e_token_type::tok_right>>,
             ct::alphyn::syntactic_unit<ct::alphyn::regexp<re_name>, token_type, token_type::generate_token_with_type<e_token_type::tok_name>>,
             ct::alphyn::syntactic_unit<ct::alphyn::regexp<re_terminal_sq>, token_type, token_type::generate_token_with_type<e_token_type::tok_terminal>>,
             ct::alphyn::syntactic_unit<ct::alphyn::regexp<re_terminal_dq>, token_type, token_type::generate_token_with_type<e_token_type::tok_terminal>>,
@@ -273,6 +279,7 @@ namespace neam
             struct type
             {
               static constexpr bool is_terminal = false;
+              static constexpr bool is_precedence = false;
               static constexpr const char *orig_str = TokName::token.s;
               static constexpr size_t index = TokName::token.start_index;
               static constexpr size_t end_index = TokName::token.end_index;
@@ -294,6 +301,22 @@ namespace neam
             };
           };
 
+          // %left / %right
+          template<associativity Associativity, typename List>
+          struct create_precedence
+          {
+            struct type
+            {
+              static constexpr bool is_precedence = true;
+              static constexpr associativity assoc = Associativity;
+              using list = List;
+            };
+          };
+          template<typename TokAssoc, typename List, typename TokLineEnd>
+          struct create_left_precedence : public create_precedence<associativity::left, List> {};
+          template<typename TokAssoc, typename List, typename TokLineEnd>
+          struct create_right_precedence : public create_precedence<associativity::right, List> {};
+
           template<typename Rule>
           struct create_syntax
           {
@@ -306,17 +329,22 @@ namespace neam
             using type = typename Syntax::template prepend<Rule>;
           };
 
-          // Syntax is a type_list of rules, rules are a type_list of {name / expr},
+          // ParsedSyntax is a type_list of rules and precedence declarations, rules are a type_list of {name / expr},
           // expr is a list of { list / attributes } and list a list of non-/terminals
           //
           // THIS IS THE FINAL BOSS OF THE BNF PARSER.
           //
-          template<typename Syntax, typename>
+          template<typename ParsedSyntax, typename>
           struct create_output_type
           {
             using token_type = ::neam::ct::alphyn::bnf::token_type;
             using type_t = typename token_type::type_t;
 
+            // split the rules and the precedence declarations (%left / %right)
+            template<typename X> struct is_precedence { static constexpr bool value = X::is_precedence; };
+            using Syntax = typename ParsedSyntax::template remove_if<is_precedence>;
+            using precedence_declarations = typename ParsedSyntax::template filter_by<is_precedence>;
+
             static constexpr bool strmatch(const char *s, size_t s_index, size_t s_end_index, const char *o, size_t o_index, size_t o_end_index)
             {
               size_t i = s_index;
@@ -434,10 +462,27 @@ namespace neam
                 using type = typename ct::extract_types<production_rule_set, typename ParsedPRS::expr::template for_each<pr_maker>>::type;
               };
 
+              // create the precedence levels
+              template<typename ParsedPrecedence>
+              struct precedence_maker
+              {
+                template<typename... Tokens> // Tokens are embed<type_t, ...>'s
+                using precedence_level = ct::alphyn::internal::precedence_level<SyntaxClass, ParsedPrecedence::assoc, Tokens::value...>;
+
+                template<typename X>
+                using type_t_list = embed::embed<type_t, get_term_id<X>::id>;
+
+                using type = typename ct::extract_types<precedence_level, typename ParsedPrecedence::list::template direct_for_each<type_t_list>>::type;
+              };
+
               template<typename... PRS>
               using pre_grammar = ct::alphyn::grammar<SyntaxClass, base_non_terminal_index, PRS...>;
 
-              using grammar = typename ct::extract_types<pre_grammar, typename Syntax::template for_each<prs_maker>>::type;
+              using grammar = typename ct::extract_types
+              <
+                pre_grammar,
+                typename Syntax::template for_each<prs_maker>::template append_list<typename precedence_declarations::template for_each<precedence_maker>>
+              >::type;
             };
 
             // for get_name_for_token_type()
@@ -523,7 +568,9 @@ namespace neam
               production_rule<ct::alphyn::synthesizer_attribute<add_rule_to_syntax>, rule, syntax>                // syntax -> syntax rule
             >,
             production_rule_set<rule,
-              production_rule<ct::alphyn::synthesizer_attribute<create_rule>, tok_name, tok_affect, expression, tok_line_end>         // rule -> name ::= expression ;
+              production_rule<ct::alphyn::synthesizer_attribute<create_rule>, tok_name, tok_affect, expression, tok_line_end>,        // rule -> name ::= expression ;
+              production_rule<ct::alphyn::synthesizer_attribute<create_left_precedence>, tok_left, list, tok_line_end>,               // rule -> %left list ;
+              production_rule<ct::alphyn::synthesizer_attribute<create_right_precedence>, tok_right, list, tok_line_end>              // rule -> %right list ;
             >,
             production_rule_set<expression,
               production_rule<ct::alphyn::synthesizer_attribute<create_expression>, list, tok_attribute>,                             // expression -> list [attribute-name]
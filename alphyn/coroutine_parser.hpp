@@ -0,0 +1,204 @@
+//
+// file : coroutine_parser.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2580627141950321463_1183913027__COROUTINE_PARSER_HPP__
+# define __N_2580627141950321463_1183913027__COROUTINE_PARSER_HPP__
+
+// This file is NOT included by alphyn.hpp: it needs C++20 coroutines (the rest of alphyn only needs C++14)
+#if !defined(__cpp_impl_coroutine)
+# error "alphyn/coroutine_parser.hpp needs a compiler with C++20 coroutines (-std=c++20)"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <optional>
+
+#include "push_parser.hpp"
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      /// \brief A (lazy) coroutine task that returns a T.
+      /// It starts when it is co_awaited (or when resume() is called), and resumes its awaiter when it's done.
+      template<typename T>
+      class parse_task
+      {
+        public:
+          struct promise_type
+          {
+            std::optional<T> value;
+            std::exception_ptr exception;
+            std::coroutine_handle<> continuation;
+
+            parse_task get_return_object()
+            {
+              return parse_task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct final_awaiter
+            {
+              bool await_ready() noexcept { return false; }
+              std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+              {
+                if (h.promise().continuation)
+                  return h.promise().continuation;
+                return std::noop_coroutine();
+              }
+              void await_resume() noexcept {}
+            };
+            final_awaiter final_suspend() noexcept { return {}; }
+
+            void return_value(T v) { value.emplace(std::move(v)); }
+            void unhandled_exception() { exception = std::current_exception(); }
+          };
+
+        public:
+          parse_task(parse_task &&o) noexcept : handle(std::exchange(o.handle, nullptr)) {}
+          parse_task &operator = (parse_task &&o) noexcept
+          {
+            if (this != &o)
+            {
+              if (handle)
+                handle.destroy();
+              handle = std::exchange(o.handle, nullptr);
+            }
+            return *this;
+          }
+          parse_task(const parse_task &) = delete;
+          parse_task &operator = (const parse_task &) = delete;
+
+          ~parse_task()
+          {
+            if (handle)
+              handle.destroy();
+          }
+
+          /// \brief Start / resume the task (when it is not awaited by another coroutine)
+          void resume()
+          {
+            if (handle && !handle.done())
+              handle.resume();
+          }
+
+          /// \brief Return true if the task has finished
+          bool done() const
+          {
+            return !handle || handle.done();
+          }
+
+          /// \brief Return the result. The task must be done. (re-throw the exception if the task has thrown)
+          T &get()
+          {
+            if (handle.promise().exception)
+              std::rethrow_exception(handle.promise().exception);
+            return *handle.promise().value;
+          }
+
+          // awaitable interface
+          bool await_ready() const noexcept { return done(); }
+          std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+          {
+            handle.promise().continuation = awaiter;
+            return handle;
+          }
+          T await_resume()
+          {
+            return std::move(get());
+          }
+
+        private:
+          explicit parse_task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+        private:
+          std::coroutine_handle<promise_type> handle;
+      };
+
+      /// \brief The result of async_parse()
+      template<typename ReturnType>
+      struct async_parse_result
+      {
+        bool success = false;       ///< \brief true if the input has been parsed
+        ReturnType value = ReturnType(); ///< \brief The result (if success is true)
+        size_t error_offset = 0;    ///< \brief The offset (from the beginning of the input) of the token that caused the error (if success is false)
+        bool buffer_full = false;   ///< \brief true if the error is because the input kept in memory would have been bigger than max_buffer_size
+      };
+
+      /// \brief Parse the input given by an asynchronous source, suspending when the source has nothing to give.
+      /// The source must have a read() method that returns an awaitable, and the result of the co_await must have data() and size()
+      /// (std::string_view, std::string, std::span<const char>, ...). An empty chunk means the end of the input.
+      /// \code
+      /// struct my_socket_source
+      /// {
+      ///   my_awaitable_read read(); // co_await read() -> std::string_view
+      /// };
+      ///
+      /// parse_task<async_parse_result<float>> task = async_parse<math_eval::parser, float>(source);
+      /// // co_await task; (or task.resume() and let the source resume it when there's some data)
+      /// \endcode
+      /// The state of the parse lives in the coroutine frame (a push_parser), so an idle parse only costs its frame.
+      /// Using a parser with a growable_stack<> keeps that frame small.
+      /// \see push_parser
+      template<typename Parser, typename ReturnType, typename Source>
+      parse_task<async_parse_result<ReturnType>> async_parse(Source &source, size_t max_buffer_size = size_t(-1),
+                                                             size_t max_token_size = push_parser<Parser, ReturnType>::default_max_token_size)
+      {
+        // If you see this, your grammar has attributes that request an arena: the arena lives in the coroutine frame,
+        // so the result would not outlive the coroutine.
+        static_assert(!Parser::syntax_class::grammar::uses_arena, "async_parse can't be used with grammars that use an arena");
+
+        using push_parser_t = push_parser<Parser, ReturnType>;
+        push_parser_t pp(max_buffer_size, max_token_size);
+
+        typename push_parser_t::status st = push_parser_t::need_more_input;
+        while (st == push_parser_t::need_more_input)
+        {
+          auto chunk = co_await source.read();
+          if (chunk.size() == 0)
+            st = pp.finish();
+          else
+            st = pp.feed(chunk.data(), chunk.size());
+        }
+
+        async_parse_result<ReturnType> result;
+        result.success = (st == push_parser_t::done);
+        if (result.success)
+          result.value = std::move(pp.get_result());
+        else
+        {
+          result.error_offset = pp.get_error_offset();
+          result.buffer_full = pp.is_buffer_full();
+        }
+        co_return result;
+      }
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_2580627141950321463_1183913027__COROUTINE_PARSER_HPP__*/
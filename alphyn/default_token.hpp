@@ -39,6 +39,10 @@ namespace neam
       /// \brief The invalid token type for the default token object
       constexpr long invalid_token_type = -1;
 
+      /// \brief The error token type: a terminal that the lexer never generates, but that can be used in the production rules
+      /// to recover from syntax errors (see parser::parse_string_with_recovery())
+      constexpr long error_token_type = -2;
+
       /// \brief A default token class, in the case this is useful for your usage
       /// \note ValueType MUST be default and copy constructible (that's the only requirement on ValueType)
       ///       And if you can make the default and the copy constructors constexpr, that could unleash the power of alphyn ! :)
@@ -0,0 +1,1155 @@
+//
+// file : glr_parser.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1127409826163125531_3041895537__GLR_PARSER_HPP__
+# define __N_1127409826163125531_3041895537__GLR_PARSER_HPP__
+
+#include <vector>
+
+#include "parser.hpp"
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        constexpr size_t _max_of(size_t a, size_t b) { return a > b ? a : b; }
+        constexpr size_t max_of() { return 0; }
+        template<typename... Values>
+        constexpr size_t max_of(size_t v, Values... vs) { return _max_of(v, max_of(vs...)); }
+
+        /// \brief Tell if SyntaxClass has a merge_ambiguity() function for values of type T (see glr_parser)
+        template<typename SyntaxClass, typename T, typename = void>
+        struct has_merge_ambiguity : public std::false_type {};
+        template<typename SyntaxClass, typename T>
+        struct has_merge_ambiguity<SyntaxClass, T, typename make_void<decltype(T(SyntaxClass::merge_ambiguity(std::declval<typename SyntaxClass::token_type::type_t>(), std::declval<T &&>(), std::declval<T &&>())))>::type>
+          : public std::true_type {};
+
+        /// \brief Copy a value if it can be copied, else move it
+        template<typename T> T copy_or_move(T &value, std::true_type /*is_copyable*/) { return value; }
+        template<typename T> T copy_or_move(T &value, std::false_type /*is_copyable*/) { return std::move(value); }
+
+        /// \brief Like a vector, but shrinking it keeps the elements: they are reused (like the slots of the parser stack)
+        template<typename T>
+        class glr_pool
+        {
+          public:
+            /// \brief Add an element at the end (its content is whatever was there before) and return its index
+            size_t push()
+            {
+              if (count == data.size())
+                data.emplace_back();
+              return count++;
+            }
+            T &operator[](size_t index) { return data[index]; }
+            const T &operator[](size_t index) const { return data[index]; }
+            size_t size() const { return count; }
+            /// \brief Forget the elements from \p new_size
+            void shrink(size_t new_size) { count = new_size; }
+            void clear() { count = 0; }
+
+          private:
+            std::vector<T> data;
+            size_t count = 0;
+        };
+
+        template<typename SyntaxClass> struct glr_gss;
+
+        /// \brief What the GLR parser knows about a production rule
+        template<typename SyntaxClass>
+        struct glr_rule_info
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+
+          type_t name;
+          size_t size;
+          const type_t *rhs;
+          size_t priority; ///< \brief The position of the rule in the grammar
+          /// \brief Call the attribute of the rule with the values of the symbols \p children, the result goes in the symbol \p dest
+          void (*call)(glr_gss<SyntaxClass> &, const size_t *children, size_t dest, size_t consumer_uses);
+        };
+
+        /// \brief The graph-structured stack of the GLR parser.
+        /// Nodes are (state, position) pairs, and links go from a node to the node it has been pushed on (so stacks that share a prefix
+        /// share the nodes of that prefix). Each link has a symbol: a token, or a non-terminal with its derivations (alternatives)
+        /// or its value, once computed.
+        template<typename SyntaxClass>
+        struct glr_gss
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using return_type_list = typename SyntaxClass::grammar::return_type_list;
+
+          struct node
+          {
+            size_t state;
+            size_t position;    // the number of tokens before the node (of symbols, for the stack taken from the parser)
+            size_t link;        // the first link (-1 for the root)
+            bool processed;     // the reductions of the node have been done
+          };
+          struct link
+          {
+            size_t pred;        // the node below
+            size_t symbol;
+            size_t next;        // the next link of the same node
+          };
+          struct symbol
+          {
+            type_t type;
+            size_t start;         // the position of its first token
+            size_t alternatives;  // the first alternative (-1 if none)
+            size_t uses;          // the number of alternatives it is a child of
+            size_t value_type;    // the index (in return_type_list) of the type of the value
+            bool resolved;        // the value has been computed
+            const glr_rule_info<SyntaxClass> *rule; // the rule of the derivation that gave the value (nullptr for the tokens)
+            value_slot<return_type_list> value;
+          };
+          struct alternative
+          {
+            const glr_rule_info<SyntaxClass> *rule;
+            size_t children;    // index in the children pool
+            size_t next;        // the next alternative of the same symbol
+          };
+
+          glr_pool<node> nodes;
+          glr_pool<link> links;
+          glr_pool<symbol> symbols;
+          glr_pool<alternative> alternatives;
+          glr_pool<size_t> children;
+
+          std::vector<size_t> heads;
+          std::vector<size_t> next_heads;
+
+          // where the stack is (only) a stack: what is after those indexes has been pushed when there was only one head
+          size_t node_mark = 0;
+          size_t link_mark = 0;
+          size_t symbol_mark = 0;
+
+          type_t lookahead = type_t();
+          bool at_end = false;
+          size_t position = 0;
+          size_t accepted = -1;
+          size_t error_state = -1;
+
+          size_t ambiguity_count = 0;
+          size_t max_stack_count = 0;
+
+          arena *memory_arena = nullptr;
+          const line_index *lines = nullptr;
+          user_context_t<SyntaxClass> *user_context = nullptr;
+
+          void reset()
+          {
+            nodes.clear();
+            links.clear();
+            symbols.clear();
+            alternatives.clear();
+            children.clear();
+            heads.clear();
+            next_heads.clear();
+            node_mark = link_mark = symbol_mark = 0;
+            position = 0;
+            accepted = -1;
+            error_state = -1;
+            ambiguity_count = 0;
+            max_stack_count = 1;
+          }
+
+          arena *get_arena() const { return memory_arena; }
+          const line_index *get_line_index() const { return lines; }
+          user_context_t<SyntaxClass> *get_user_context() const { return user_context; }
+
+          /// \brief Set the marks at the end of the pools
+          void mark()
+          {
+            node_mark = nodes.size();
+            link_mark = links.size();
+            symbol_mark = symbols.size();
+          }
+
+          size_t new_symbol(type_t type, size_t start)
+          {
+            const size_t index = symbols.push();
+            symbol &s = symbols[index];
+            s.type = type;
+            s.start = start;
+            s.alternatives = -1;
+            s.uses = 0;
+            s.value_type = -1;
+            s.resolved = false;
+            s.rule = nullptr;
+            return index;
+          }
+
+          size_t new_link(size_t from, size_t pred, size_t symbol_index)
+          {
+            const size_t index = links.push();
+            links[index] = link {pred, symbol_index, nodes[from].link};
+            nodes[from].link = index;
+            return index;
+          }
+
+          /// \brief Create a node (and its link to \p pred, if it isn't -1)
+          size_t new_node(size_t state, size_t pred, size_t symbol_index)
+          {
+            const size_t index = nodes.push();
+            nodes[index] = node {state, position, size_t(-1), false};
+            if (pred != size_t(-1))
+              new_link(index, pred, symbol_index);
+            return index;
+          }
+
+          /// \brief Return the head (at the current position) that is in the state \p state, -1 if there's none
+          size_t find_head(size_t state) const
+          {
+            for (size_t head : heads)
+            {
+              if (nodes[head].state == state)
+                return head;
+            }
+            return -1;
+          }
+        };
+
+        /// \brief Retrieve an argument for an attribute from a symbol.
+        /// Values are moved out of the symbol if nothing else uses it, else they are copied (if possible).
+        template<typename Arg>
+        struct glr_argument
+        {
+          template<typename Symbol>
+          static std::decay_t<Arg> get(Symbol &s, size_t consumer_uses)
+          {
+            std::decay_t<Arg> &value = s.value.template get<Arg>();
+            if (s.uses <= consumer_uses)
+              return std::move(value);
+            return copy_or_move(value, std::is_copy_constructible<std::decay_t<Arg>>());
+          }
+        };
+        template<typename Arg>
+        struct glr_argument<Arg &>
+        {
+          template<typename Symbol>
+          static Arg &get(Symbol &s, size_t)
+          {
+            return s.value.template get<Arg>();
+          }
+        };
+
+        /// \brief What the GLR parser does with the values of a given type (a table indexed by the index of the type in return_type_list)
+        template<typename SyntaxClass, typename TypeList = typename SyntaxClass::grammar::return_type_list>
+        struct glr_value_ops {};
+
+        template<typename SyntaxClass, typename... Types>
+        struct glr_value_ops<SyntaxClass, ct::type_list<Types...>>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using symbol = typename glr_gss<SyntaxClass>::symbol;
+
+          struct entry
+          {
+            void (*transfer)(symbol &dest, symbol &src, size_t consumer_uses);
+            void (*merge)(symbol &dest, symbol &other);
+            bool can_merge;
+          };
+
+          template<typename T>
+          static void transfer(symbol &dest, symbol &src, size_t consumer_uses)
+          {
+            dest.value.template get<T>() = glr_argument<T>::get(src, consumer_uses);
+          }
+
+          template<typename T>
+          static void merge(symbol &dest, symbol &other)
+          {
+            _merge<T>(dest, other, has_merge_ambiguity<SyntaxClass, T>());
+          }
+          template<typename T>
+          static void _merge(symbol &dest, symbol &other, std::true_type)
+          {
+            T &value = dest.value.template get<T>();
+            value = SyntaxClass::merge_ambiguity(dest.type, std::move(value), std::move(other.value.template get<T>()));
+          }
+          template<typename T>
+          static void _merge(symbol &, symbol &, std::false_type) {}
+
+          static const entry table[sizeof...(Types)];
+        };
+        template<typename SyntaxClass, typename... Types>
+        const typename glr_value_ops<SyntaxClass, ct::type_list<Types...>>::entry glr_value_ops<SyntaxClass, ct::type_list<Types...>>::table[sizeof...(Types)] =
+        {
+          {
+            &glr_value_ops<SyntaxClass, ct::type_list<Types...>>::template transfer<Types>,
+            &glr_value_ops<SyntaxClass, ct::type_list<Types...>>::template merge<Types>,
+            has_merge_ambiguity<SyntaxClass, Types>::value
+          }...
+        };
+
+        /// \brief A production rule for the GLR parser (its attribute is called with the values of the symbols of a derivation)
+        template<typename SyntaxClass, typename SyntaxClass::token_type::type_t Name, typename TypeList, typename Attribute>
+        struct glr_rule {};
+
+        template<typename SyntaxClass, typename SyntaxClass::token_type::type_t Name, typename... Elems, typename Attribute>
+        struct glr_rule<SyntaxClass, Name, ct::type_list<Elems...>, Attribute>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using gss_t = glr_gss<SyntaxClass>;
+          using grammar = typename SyntaxClass::grammar;
+          using return_type_list = typename grammar::return_type_list;
+
+
+          static constexpr type_t rhs[] = {Elems::value...};
+          static const glr_rule_info<SyntaxClass> info;
+
+          static void call(gss_t &gss, const size_t *children, size_t dest, size_t consumer_uses)
+          {
+            sub_call(gss, Attribute::function, children, dest, consumer_uses);
+          }
+
+        private:
+          template<typename Arg>
+          static decltype(auto) _get_argument(gss_t &gss, const size_t *children, size_t index, size_t consumer_uses, std::false_type /*is_injected*/)
+          {
+            return glr_argument<Arg>::get(gss.symbols[children[index]], consumer_uses);
+          }
+          template<typename Arg>
+          static decltype(auto) _get_argument(gss_t &gss, const size_t *, size_t, size_t, std::true_type /*is_injected*/)
+          {
+            return injected_argument<SyntaxClass, Arg>::get(gss);
+          }
+
+          template<typename Ret, typename... Args, size_t... Idxs>
+          static Ret _fwd_call(gss_t &gss, Ret (*function)(Args...), const size_t *children, size_t consumer_uses, cr::seq<Idxs...>)
+          {
+            // the first parameters may be injected, the others are taken from the symbols
+            constexpr size_t injected_count = injected_parameter_count<SyntaxClass, Args...>::value;
+            return function(_get_argument<Args>(gss, children, Idxs - injected_count, consumer_uses, is_injected_parameter<SyntaxClass, Args>())...);
+          }
+
+          template<typename Ret, typename... Args>
+          static void sub_call(gss_t &gss, Ret (*function)(Args...), const size_t *children, size_t dest, size_t consumer_uses)
+          {
+            Ret value = _fwd_call(gss, function, children, consumer_uses, cr::gen_seq<sizeof...(Args)>());
+            gss.symbols[dest].value.template get<Ret>() = std::move(value);
+            gss.symbols[dest].value_type = return_type_list::template get_type_index<std::decay_t<Ret>>::index;
+          }
+
+          template<template<e_forward_mode> class Type>
+          static void sub_call(gss_t &gss, Type<e_forward_mode::direct>, const size_t *children, size_t dest, size_t consumer_uses)
+          {
+            using attr = Type<e_forward_mode::direct>;
+            auto &src = gss.symbols[children[attr::index]];
+            if (children[attr::index] != dest)
+              glr_value_ops<SyntaxClass>::table[src.value_type].transfer(gss.symbols[dest], src, consumer_uses);
+            gss.symbols[dest].value_type = src.value_type;
+          }
+
+          template<template<e_forward_mode> class Type>
+          static void sub_call(gss_t &gss, Type<e_forward_mode::token_value>, const size_t *children, size_t dest, size_t)
+          {
+            using attr = Type<e_forward_mode::direct>;
+            using result_type = typename SyntaxClass::token_type::value_t;
+            result_type value = gss.symbols[children[attr::index]].value.template get<typename SyntaxClass::token_type>().value;
+            gss.symbols[dest].value.template get<result_type>() = std::move(value);
+            gss.symbols[dest].value_type = return_type_list::template get_type_index<result_type>::index;
+          }
+        };
+        template<typename SyntaxClass, typename SyntaxClass::token_type::type_t Name, typename... Elems, typename Attribute>
+        constexpr typename SyntaxClass::token_type::type_t glr_rule<SyntaxClass, Name, ct::type_list<Elems...>, Attribute>::rhs[];
+        template<typename SyntaxClass, typename SyntaxClass::token_type::type_t Name, typename... Elems, typename Attribute>
+        const glr_rule_info<SyntaxClass> glr_rule<SyntaxClass, Name, ct::type_list<Elems...>, Attribute>::info =
+        {
+          Name, sizeof...(Elems), glr_rule<SyntaxClass, Name, ct::type_list<Elems...>, Attribute>::rhs,
+          _rule_id<SyntaxClass, Name, ct::type_list<Elems...>, Attribute>::value,
+          &glr_rule<SyntaxClass, Name, ct::type_list<Elems...>, Attribute>::call
+        };
+
+        /// \brief A state of the automaton, for the GLR parser: unlike parser_state, it returns every possible action
+        template<typename SyntaxClass, typename State, typename StateList>
+        struct glr_state
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+
+          /// \brief Find the edge named \p type
+          template<typename List, bool = false>
+          struct edge_finder
+          {
+            static size_t find(type_t type)
+            {
+              using current_edge = typename List::front;
+              if (current_edge::name == type)
+                return StateList::template get_type_index<typename current_edge::state>::index;
+              return edge_finder<typename List::pop_front>::find(type);
+            }
+          };
+          template<bool X>
+          struct edge_finder<ct::type_list<>, X>
+          {
+            static size_t find(type_t)
+            {
+              return -1;
+            }
+          };
+
+          template<typename FollowSet> struct follow_set {};
+          template<typename... Follows>
+          struct follow_set<ct::type_list<Follows...>>
+          {
+            static bool matches(type_t lookahead, bool at_end)
+            {
+              // only the start rule has an empty follow set: it is reduced at the end of the input
+              (void)lookahead;
+              return sizeof...(Follows) ? any_of((Follows::value == lookahead)...) : at_end;
+            }
+          };
+
+          template<typename Tokens> struct token_list {};
+          template<typename... Tokens>
+          struct token_list<ct::type_list<Tokens...>>
+          {
+            static bool contains(type_t type)
+            {
+              (void)type; // (when there's no tokens)
+              return any_of((Tokens::value == type)...);
+            }
+          };
+
+          template<typename Rules> struct reductions {};
+          template<typename... Rules>
+          struct reductions<ct::type_list<Rules...>>
+          {
+            static size_t get(type_t lookahead, bool at_end, const glr_rule_info<SyntaxClass> **rules)
+            {
+              (void)lookahead; (void)at_end; (void)rules; // (when there's no rules)
+              size_t count = 0;
+              NEAM_EXECUTE_PACK(
+                follow_set<typename Rules::follow_set>::matches(lookahead, at_end)
+                && (rules[count++] = &glr_rule<SyntaxClass, Rules::rule_name, typename Rules::as_type_list, typename Rules::attribute>::info)
+              );
+              return count;
+            }
+          };
+
+          /// \brief Return the state the edge named \p type leads to, -1 if there's none
+          static size_t find_edge(type_t type)
+          {
+            return edge_finder<typename State::edges>::find(type);
+          }
+
+          /// \brief Return the state reached by shifting \p type, -1 if it can't be shifted
+          /// (conflicts that the precedence levels have resolved in favor of a reduction are not kept)
+          static size_t find_shift(type_t type)
+          {
+            if (token_list<typename _reduced_by_precedence<SyntaxClass, typename State::final_rules>::list>::contains(type))
+              return -1;
+            return find_edge(type);
+          }
+
+          /// \brief Put in \p rules the rules that can be reduced with that lookahead, and return their number
+          static size_t get_reductions(type_t lookahead, bool at_end, const glr_rule_info<SyntaxClass> **rules)
+          {
+            return reductions<typename State::final_rules>::get(lookahead, at_end, rules);
+          }
+        };
+
+        /// \brief The states of the automaton, in a table (in the order of the automaton list)
+        template<typename SyntaxClass, typename AutomatonList, typename StateList = decltype(as_plain_type_list(static_cast<AutomatonList *>(nullptr)))>
+        struct glr_table {};
+
+        template<typename SyntaxClass, typename AutomatonList, typename... States>
+        struct glr_table<SyntaxClass, AutomatonList, ct::type_list<States...>>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+
+          struct entry
+          {
+            size_t (*find_edge)(type_t);
+            size_t (*find_shift)(type_t);
+            size_t (*get_reductions)(type_t, bool, const glr_rule_info<SyntaxClass> **);
+          };
+          static const entry table[sizeof...(States)];
+
+          /// \brief The maximum number of rules a state can reduce
+          static constexpr size_t max_reductions = max_of(States::final_rules::size...);
+        };
+        template<typename SyntaxClass, typename AutomatonList, typename... States>
+        const typename glr_table<SyntaxClass, AutomatonList, ct::type_list<States...>>::entry glr_table<SyntaxClass, AutomatonList, ct::type_list<States...>>::table[sizeof...(States)] =
+        {
+          {
+            &glr_state<SyntaxClass, States, AutomatonList>::find_edge,
+            &glr_state<SyntaxClass, States, AutomatonList>::find_shift,
+            &glr_state<SyntaxClass, States, AutomatonList>::get_reductions
+          }...
+        };
+
+        /// \brief The types the values of the symbol Name can have: the token type for a terminal, the types returned by the attributes
+        /// of its rules for a non-terminal (a rule that forwards a value has the types of the symbol it forwards)
+        template<typename SyntaxClass, typename SyntaxClass::token_type::type_t Name, typename Visited = ct::type_list<>>
+        struct glr_symbol_types
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using grammar = typename SyntaxClass::grammar;
+          using name = embed::embed<type_t, Name>;
+
+          template<typename RS> struct is_rule_set { static constexpr bool value = (RS::rule_name == Name); };
+          static constexpr long set_index = grammar::as_type_list::template find_if<is_rule_set>::index;
+
+          template<typename Attribute, typename Elems>
+          struct of_rule { using type = ct::type_list<std::decay_t<typename Attribute::return_type>>; };
+          template<size_t Index, typename Elems>
+          struct of_rule<forward_attribute<Index>, Elems>
+          {
+            using type = typename glr_symbol_types<SyntaxClass, Elems::template get_type<Index>::value, typename Visited::template append<name>>::list;
+          };
+          template<size_t Index, typename Elems>
+          struct of_rule<value_forward_attribute<Index>, Elems> { using type = ct::type_list<typename SyntaxClass::token_type::value_t>; };
+          template<typename PR> struct rule_types { using type = typename of_rule<typename PR::attribute, typename PR::as_type_list>::type; };
+
+          // (a non-terminal that is already being visited adds nothing: its other rules are already accounted)
+          template<long SetIndex, bool IsVisited>
+          struct _switch { using list = typename grammar::as_type_list::template get_type<SetIndex>::as_type_list::template for_each<rule_types>::flatten::make_unique; };
+          template<long SetIndex> struct _switch<SetIndex, true> { using list = ct::type_list<>; };
+          template<bool IsVisited> struct _switch<-1, IsVisited> { using list = ct::type_list<typename SyntaxClass::token_type>; };
+
+          using list = typename _switch<set_index, ct::is_in_list<Visited, name>::value>::list;
+        };
+
+        /// \brief The type of the value of every symbol, as an index in return_type_list (-1 for the symbols whose values can have different types)
+        template<typename SyntaxClass, typename NonTerminalList = typename SyntaxClass::grammar::non_terminal_list>
+        struct glr_value_types {};
+
+        template<typename SyntaxClass, typename... NonTerminals>
+        struct glr_value_types<SyntaxClass, ct::type_list<NonTerminals...>>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using return_type_list = typename SyntaxClass::grammar::return_type_list;
+
+          template<typename List> struct _index { static constexpr size_t value = -1; };
+          template<typename Type> struct _index<ct::type_list<Type>> { static constexpr size_t value = size_t(return_type_list::template get_type_index<Type>::index); };
+          template<type_t Name> using of = _index<typename glr_symbol_types<SyntaxClass, Name>::list>;
+
+          /// \brief true if the type of the value of every symbol is known
+          static constexpr bool all_known = !any_of((of<NonTerminals::value>::value == size_t(-1))...);
+
+          /// \brief Return the index of the type of the values of the symbol \p type
+          static size_t get(type_t type)
+          {
+            size_t index = _index<ct::type_list<typename SyntaxClass::token_type>>::value; // (a terminal)
+            NEAM_EXECUTE_PACK(
+              (NonTerminals::value == type) && (index = of<NonTerminals::value>::value)
+            );
+            return index;
+          }
+        };
+
+        /// \brief The size of the longest production rule of a list of production_rule_set
+        template<typename RuleSets> struct max_rule_size {};
+        template<typename... RuleSets>
+        struct max_rule_size<ct::type_list<RuleSets...>>
+        {
+          template<typename Rules> struct of_set {};
+          template<typename... Rules> struct of_set<ct::type_list<Rules...>> { static constexpr size_t value = max_of(Rules::as_type_list::size...); };
+
+          static constexpr size_t value = max_of(of_set<typename RuleSets::as_type_list>::value...);
+        };
+      } // namespace internal
+
+      /// \brief A GLR parser: it uses the canonical LR(1) automaton of the grammar, but where that automaton has a conflict
+      /// (more than one thing to do with the current token) it does all of them, forking the stack.
+      /// The stacks are stored in a graph-structured stack: they share their common prefix, and stacks that arrive in the same state
+      /// at the same position are merged. Stacks that can't go further simply disappear. This way grammars that are ambiguous or that
+      /// need more than one token of lookahead can be used without contorting them to fit LR(1).
+      /// \code
+      /// neam::ct::alphyn::glr_parser<my_dsl>::parse_string<node *>(ctx, str);
+      /// \endcode
+      ///
+      /// Until the first conflict, the input is parsed by a parser (lr_parser, that has the stop_on_conflicts policy): its stack is then
+      /// put in the graph-structured stack, where the parse goes on. While there's only one stack, the attributes are called as the rules
+      /// are reduced (like the parser does).
+      /// During a fork, the reductions are only recorded, and their attributes are called once the stacks have merged back
+      /// (or when the parse is done): attributes of the stacks that have failed are never called.
+      /// When a part of the input has more than one derivation (an ambiguity), the derivation of the rule that comes first in the grammar
+      /// is kept (and for the same rule, the one that reduces first, as the parser does). If SyntaxClass has a merge function for the
+      /// type of the value, every derivation is computed and merged instead:
+      /// \code static float merge_ambiguity(type_t non_terminal, float &&first, float &&second); \endcode
+      ///
+      /// \note Unlike the parser, the values of the symbols that are shared by more than one derivation are copied (if they can be) before
+      ///       being given to the attributes (a value taken by reference is the same for every derivation).
+      /// \note The result of the parse is a parse_result (nothing is thrown, see on_parse_error::return_result)
+      template<typename SyntaxClass>
+      class glr_parser
+      {
+        public:
+          using syntax_class = SyntaxClass;
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using automaton = typename grammar_tools<SyntaxClass>::lr1_automaton;
+          using automaton_list = typename automaton::as_type_list;
+          static_assert(automaton_list::template get_type_index<automaton>::index == 0, "the initial state must be the first state of the automaton");
+          /// \brief The number of states of the automaton
+          static constexpr size_t state_count = automaton_list::size;
+          /// \brief The user context type (SyntaxClass::context_type, if it exists)
+          using user_context_t = internal::user_context_t<SyntaxClass>;
+          template<typename ReturnType>
+          using result_t = parse_result<ReturnType, type_t>;
+          /// \brief The parser that parses the input until the first conflict (it uses the same automaton)
+          using lr_parser = parser<SyntaxClass, on_parse_error::return_result, growable_stack<>, stop_on_conflicts>;
+          static_assert(std::is_same<typename lr_parser::automaton_list, automaton_list>::value, "the parser must use the automaton of the glr_parser");
+
+          /// \brief Holds everything the GLR parser needs at runtime (the stack of lr_parser, the graph-structured stack, the arena and the line index)
+          /// Like the parser_context, it can be reused between parses (so that its memory is reused too).
+          class context
+          {
+            public:
+              /// \param arena_block_size The size of the blocks of the arena (only used if the grammar needs an arena)
+              explicit context(size_t arena_block_size = arena::default_block_size) : memory(arena_block_size) {}
+
+              context(const context &) = delete;
+              context &operator = (const context &) = delete;
+
+              /// \brief Reset the context. Called by parse_string() before each parse.
+              void reset()
+              {
+                stack.reset();
+                stack.set_arena(&memory);
+                stack.set_line_index(&lines);
+                gss.reset();
+                memory.reset();
+                gss.memory_arena = &memory;
+                gss.lines = &lines;
+              }
+
+              /// \brief Reset the context and bind the line index to \p str, the string that will be parsed
+              void reset(const char *str)
+              {
+                reset();
+                lines.reset(str);
+              }
+
+              /// \brief Return the arena of the context
+              arena &get_arena()
+              {
+                return memory;
+              }
+
+              /// \brief Return the line index of the string of the last parse
+              const line_index &get_line_index() const
+              {
+                return lines;
+              }
+
+              /// \brief Return the number of ambiguities of the last parse (the parts of the result that had more than one derivation)
+              size_t get_ambiguity_count() const
+              {
+                return gss.ambiguity_count;
+              }
+
+              /// \brief Return the maximum number of stacks the last parse had at the same time (1 if it has never forked)
+              size_t get_max_stack_count() const
+              {
+                return gss.max_stack_count;
+              }
+
+            private:
+              typename lr_parser::uts_t stack;
+              internal::glr_gss<SyntaxClass> gss;
+              arena memory;
+              line_index lines;
+
+              friend glr_parser;
+          };
+
+        public:
+          /// \brief Parse the string and return the result value
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string(const char *str, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request an arena, and the arena lives in a context
+            static_assert(!SyntaxClass::grammar::uses_arena, "this grammar needs an arena: please use parse_string(context &, str, index)");
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context: please use parse_string(context &, user_context, str, index)");
+
+            context ctx;
+            return parse_string<ReturnType>(ctx, str, start_index);
+          }
+
+          /// \brief Parse the string and return the result value, re-using the memory of the context
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string(context &ctx, const char *str, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context: please use parse_string(context &, user_context, str, index)");
+
+            ctx.reset(str);
+            ctx.stack.set_user_context(nullptr);
+            ctx.gss.user_context = nullptr;
+            return _parse_string<ReturnType>(ctx, str, start_index);
+          }
+
+          /// \brief Parse the string and return the result value, giving \p user_context to the attributes that request it
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string(context &ctx, user_context_t &user_context, const char *str, size_t start_index = 0)
+          {
+            ctx.reset(str);
+            ctx.stack.set_user_context(&user_context);
+            ctx.gss.user_context = &user_context;
+            return _parse_string<ReturnType>(ctx, str, start_index);
+          }
+
+        private:
+          using gss_t = internal::glr_gss<SyntaxClass>;
+          using rule_info = internal::glr_rule_info<SyntaxClass>;
+          using states = internal::glr_table<SyntaxClass, automaton_list>;
+          using value_ops = internal::glr_value_ops<SyntaxClass>;
+          using value_types = internal::glr_value_types<SyntaxClass>;
+          using uts_t = typename lr_parser::uts_t;
+
+          static constexpr size_t max_rule_size = internal::max_rule_size<typename SyntaxClass::grammar::as_type_list>::value;
+
+          enum class step_result
+          {
+            shifted,  // the token has been shifted
+            accepted, // the start rule has been reduced
+            failed,   // no action for the token
+            fork,     // more than one action: the generic (forking) parser has to take over
+          };
+
+          template<typename ReturnType>
+          static result_t<ReturnType> _parse_string(context &ctx, const char *str, size_t start_index)
+          {
+            gss_t &gss = ctx.gss;
+            lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, start_index);
+
+            // the parser runs until the end, or until a state has more than one thing to do with the current token
+            // (it can't be used if the type of the values of a symbol depends on the rule that has been reduced: the stack doesn't say it)
+            if (value_types::all_known)
+            {
+              internal::parser_state<SyntaxClass, automaton, lr_parser>::rec_parse(ctx.stack, ll);
+              if (!ctx.stack.has_overflowed() && ctx.stack.size() == 1 && ctx.stack.get_top_type() == SyntaxClass::grammar::start_rule)
+                return result_t<ReturnType>(std::move(ctx.stack.template get<ReturnType>()));
+            }
+
+            if (!_take_over(gss, ctx.stack, ll) || !_parse(gss, ll))
+              return result_t<ReturnType>(parse_error<type_t> {ll.get_token().start_index, ll.get_token().type, gss.error_state, false});
+
+            _resolve(gss, gss.accepted);
+            return result_t<ReturnType>(std::move(gss.symbols[gss.accepted].value.template get<ReturnType>()));
+          }
+
+          /// \brief Put the stack of the parser in the graph-structured stack, as the stack of its only head
+          /// \return false if the parser has stopped on a syntax error (and not on a conflict)
+          static bool _take_over(gss_t &gss, uts_t &stack, const lexem_list<SyntaxClass> &ll)
+          {
+            size_t node = gss.new_node(0, -1, -1);
+            gss.mark();
+            const size_t state = stack.get_error_state();
+            if (state == size_t(-1)) // the parser hasn't run
+            {
+              gss.heads.push_back(node);
+              return true;
+            }
+
+            const rule_info *rules[states::max_reductions + 1];
+            const type_t lookahead = ll.get_token().type;
+            const size_t action_count = states::table[state].get_reductions(lookahead, ll.is_last(), rules)
+                                        + (states::table[state].find_shift(lookahead) != size_t(-1));
+            if (stack.has_overflowed() || action_count < 2)
+            {
+              gss.error_state = state;
+              return false;
+            }
+
+            // as there are no empty production rules, the number of symbols under a node is enough to order the nodes
+            // (which is all the positions are used for): the positions count the symbols of the stack instead of its tokens
+            for (size_t i = 0; i < stack.size(); ++i)
+            {
+              const size_t symbol = gss.new_symbol(stack.get_type(stack.size() - 1 - i), gss.position);
+              gss.symbols[symbol].value = std::move(stack.get_slot(i));
+              gss.symbols[symbol].value_type = value_types::get(gss.symbols[symbol].type);
+              gss.symbols[symbol].resolved = true;
+              ++gss.position;
+              node = gss.new_node(i + 1 < stack.size() ? stack.get_state(i + 1) : state, node, symbol);
+            }
+            gss.heads.push_back(node);
+            return true;
+          }
+
+          /// \brief The main loop: the deterministic parser runs while there's only one stack and one action, the forking one otherwise
+          static bool _parse(gss_t &gss, lexem_list<SyntaxClass> &ll)
+          {
+            while (true)
+            {
+              gss.lookahead = ll.get_token().type;
+              gss.at_end = ll.is_last();
+
+              if (gss.heads.size() == 1)
+              {
+                const step_result res = _deterministic_step(gss, ll);
+                if (res == step_result::shifted)
+                  continue;
+                if (res != step_result::fork)
+                  return res == step_result::accepted;
+              }
+
+              _reduce_all(gss);
+              if (gss.accepted != size_t(-1))
+                return true;
+              if (!_shift_all(gss, ll))
+                return false;
+              if (gss.heads.size() == 1)
+                gss.mark();
+            }
+          }
+
+          /// \brief Do what the LR parser would do, as long as there's only one thing to do
+          static step_result _deterministic_step(gss_t &gss, lexem_list<SyntaxClass> &ll)
+          {
+            const rule_info *rules[states::max_reductions + 1];
+            size_t path[max_rule_size];
+            while (true)
+            {
+              const size_t head = gss.heads[0];
+              const size_t state = gss.nodes[head].state;
+              const size_t rule_count = states::table[state].get_reductions(gss.lookahead, gss.at_end, rules);
+              const size_t shift_state = states::table[state].find_shift(gss.lookahead);
+
+              if (!rule_count)
+              {
+                if (shift_state == size_t(-1))
+                {
+                  gss.error_state = state;
+                  return step_result::failed;
+                }
+                const size_t token = gss.new_symbol(gss.lookahead, gss.position);
+                gss.symbols[token].value.template get<typename SyntaxClass::token_type>() = ll.get_token();
+                gss.symbols[token].value_type = gss_t::return_type_list::template get_type_index<typename SyntaxClass::token_type>::index;
+                gss.symbols[token].resolved = true;
+                ++gss.position;
+                gss.heads[0] = gss.new_node(shift_state, head, token);
+                ll = ll.get_next();
+                return step_result::shifted;
+              }
+              if (rule_count > 1 || shift_state != size_t(-1))
+                return step_result::fork;
+
+              // a single reduction: walk down the stack
+              const rule_info &rule = *rules[0];
+              size_t top = head; // the last node popped
+              size_t below = head;
+              for (size_t i = rule.size; i-- > 0;)
+              {
+                const size_t link_index = gss.nodes[below].link;
+                if (link_index == size_t(-1) || gss.symbols[gss.links[link_index].symbol].type != rule.rhs[i])
+                {
+                  gss.error_state = state;
+                  return step_result::failed;
+                }
+                if (gss.links[link_index].next != size_t(-1))
+                  return step_result::fork; // stacks have been merged there: there's more than one path
+                path[i] = gss.links[link_index].symbol;
+                top = below;
+                below = gss.links[link_index].pred;
+              }
+
+              // the values of the symbols that come from a fork may not have been computed
+              for (size_t i = 0; i < rule.size; ++i)
+                _resolve(gss, path[i]);
+
+              if (below == 0 && rule.name == SyntaxClass::grammar::start_rule)
+              {
+                gss.accepted = gss.new_symbol(rule.name, 0);
+                rule.call(gss, path, gss.accepted, 0);
+                gss.symbols[gss.accepted].resolved = true;
+                gss.symbols[gss.accepted].rule = &rule;
+                return step_result::accepted;
+              }
+
+              const size_t goto_state = states::table[gss.nodes[below].state].find_edge(rule.name);
+              if (goto_state == size_t(-1))
+              {
+                gss.error_state = state;
+                return step_result::failed;
+              }
+
+              size_t result;
+              if (top >= gss.node_mark)
+              {
+                // everything that is popped has been pushed by the deterministic parser: the pools are used as a stack
+                // (the result goes in the slot of the first symbol)
+                result = path[0];
+                rule.call(gss, path, result, 0);
+                gss.links.shrink(gss.nodes[top].link);
+                gss.nodes.shrink(top);
+                gss.symbols.shrink(result + 1);
+                gss.symbols[result].type = rule.name;
+              }
+              else
+              {
+                result = gss.new_symbol(rule.name, gss.nodes[below].position);
+                rule.call(gss, path, result, 0);
+              }
+              gss.symbols[result].resolved = true;
+              gss.symbols[result].rule = &rule;
+              gss.heads[0] = gss.new_node(goto_state, below, result);
+            }
+          }
+
+          /// \brief Do every reduction of every head (new heads are processed as they are created)
+          static void _reduce_all(gss_t &gss)
+          {
+            const rule_info *rules[states::max_reductions + 1];
+            for (size_t i = 0; i < gss.heads.size(); ++i)
+            {
+              const size_t head = gss.heads[i];
+              gss.nodes[head].processed = true;
+              const size_t rule_count = states::table[gss.nodes[head].state].get_reductions(gss.lookahead, gss.at_end, rules);
+              for (size_t j = 0; j < rule_count; ++j)
+                _reduce(gss, head, *rules[j], -1);
+            }
+            gss.max_stack_count = gss.heads.size() > gss.max_stack_count ? gss.heads.size() : gss.max_stack_count;
+          }
+
+          /// \brief Reduce \p rule along every path from \p head (only the ones that starts with \p first_link, if it isn't -1)
+          static void _reduce(gss_t &gss, size_t head, const rule_info &rule, size_t first_link)
+          {
+            size_t path[max_rule_size];
+            _walk(gss, head, rule.size, rule, first_link, path);
+          }
+
+          static void _walk(gss_t &gss, size_t node, size_t remaining, const rule_info &rule, size_t first_link, size_t *path)
+          {
+            if (!remaining)
+              return _reduce_path(gss, node, rule, path);
+
+            size_t link_index = first_link != size_t(-1) ? first_link : gss.nodes[node].link;
+            while (link_index != size_t(-1))
+            {
+              // the pools may grow during the recursion: nothing is kept by reference
+              const typename gss_t::link current = gss.links[link_index];
+              if (gss.symbols[current.symbol].type == rule.rhs[remaining - 1])
+              {
+                path[remaining - 1] = current.symbol;
+                _walk(gss, current.pred, remaining - 1, rule, -1, path);
+              }
+              link_index = first_link != size_t(-1) ? size_t(-1) : current.next;
+            }
+          }
+
+          /// \brief A reduction of \p rule, \p below being the node under the path
+          static void _reduce_path(gss_t &gss, size_t below, const rule_info &rule, const size_t *path)
+          {
+            if (below == 0 && rule.name == SyntaxClass::grammar::start_rule)
+            {
+              if (gss.accepted == size_t(-1))
+                gss.accepted = gss.new_symbol(rule.name, 0);
+              _add_alternative(gss, gss.accepted, rule, path);
+              return;
+            }
+
+            const size_t goto_state = states::table[gss.nodes[below].state].find_edge(rule.name);
+            if (goto_state == size_t(-1))
+              return;
+
+            size_t head = gss.find_head(goto_state);
+            if (head == size_t(-1))
+            {
+              const size_t symbol = gss.new_symbol(rule.name, gss.nodes[below].position);
+              _add_alternative(gss, symbol, rule, path);
+              gss.heads.push_back(gss.new_node(goto_state, below, symbol));
+              return;
+            }
+
+            // there's already a stack in that state: either it already has a link to below (another derivation of the same thing)
+            // or a link is added (and the reductions that go through that link are done if the head has already been processed)
+            for (size_t link_index = gss.nodes[head].link; link_index != size_t(-1); link_index = gss.links[link_index].next)
+            {
+              if (gss.links[link_index].pred == below)
+              {
+                _add_alternative(gss, gss.links[link_index].symbol, rule, path);
+                return;
+              }
+            }
+            const size_t symbol = gss.new_symbol(rule.name, gss.nodes[below].position);
+            _add_alternative(gss, symbol, rule, path);
+            const size_t new_link = gss.new_link(head, below, symbol);
+            if (gss.nodes[head].processed)
+            {
+              const rule_info *rules[states::max_reductions + 1];
+              const size_t rule_count = states::table[gss.nodes[head].state].get_reductions(gss.lookahead, gss.at_end, rules);
+              for (size_t j = 0; j < rule_count; ++j)
+                _reduce(gss, head, *rules[j], new_link);
+            }
+          }
+
+          /// \brief Record a derivation of a symbol
+          static void _add_alternative(gss_t &gss, size_t symbol, const rule_info &rule, const size_t *path)
+          {
+            const size_t children = gss.children.size();
+            for (size_t i = 0; i < rule.size; ++i)
+            {
+              gss.children[gss.children.push()] = path[i];
+              ++gss.symbols[path[i]].uses;
+            }
+            const size_t alt = gss.alternatives.push();
+            gss.alternatives[alt] = typename gss_t::alternative {&rule, children, gss.symbols[symbol].alternatives};
+            gss.symbols[symbol].alternatives = alt;
+
+            // the value has already been computed (by the deterministic parser): it's replaced if the new derivation is preferred
+            if (gss.symbols[symbol].resolved)
+            {
+              ++gss.ambiguity_count;
+              if (gss.symbols[symbol].rule && rule.priority < gss.symbols[symbol].rule->priority)
+                _prefer_alternative(gss, symbol, alt);
+              else
+                _merge_alternative(gss, symbol, alt);
+            }
+          }
+
+          /// \brief Shift the token on every head that can, the heads that can't are dropped
+          /// \return false if no head can shift the token
+          static bool _shift_all(gss_t &gss, lexem_list<SyntaxClass> &ll)
+          {
+            gss.next_heads.clear();
+            ++gss.position;
+            for (size_t head : gss.heads)
+            {
+              const size_t shift_state = states::table[gss.nodes[head].state].find_shift(gss.lookahead);
+              if (shift_state == size_t(-1))
+              {
+                gss.error_state = gss.nodes[head].state;
+                continue;
+              }
+
+              size_t next = -1;
+              for (size_t it : gss.next_heads)
+              {
+                if (gss.nodes[it].state == shift_state)
+                  next = it;
+              }
+              if (next == size_t(-1))
+              {
+                next = gss.new_node(shift_state, -1, -1);
+                gss.next_heads.push_back(next);
+              }
+
+              // one symbol per link: their values may be consumed separately
+              const size_t token = gss.new_symbol(gss.lookahead, gss.position - 1);
+              gss.symbols[token].value.template get<typename SyntaxClass::token_type>() = ll.get_token();
+              gss.symbols[token].value_type = gss_t::return_type_list::template get_type_index<typename SyntaxClass::token_type>::index;
+              gss.symbols[token].resolved = true;
+              gss.new_link(next, head, token);
+            }
+            if (gss.next_heads.empty())
+              return false;
+            gss.heads.swap(gss.next_heads);
+            ll = ll.get_next();
+            return true;
+          }
+
+          /// \brief Compute the value of a symbol (choosing or merging its derivations)
+          static void _resolve(gss_t &gss, size_t symbol)
+          {
+            if (gss.symbols[symbol].resolved)
+              return;
+            gss.symbols[symbol].resolved = true;
+
+            size_t best = gss.symbols[symbol].alternatives;
+            for (size_t alt = gss.alternatives[best].next; alt != size_t(-1); alt = gss.alternatives[alt].next)
+            {
+              if (_is_preferred(gss, alt, best))
+                best = alt;
+            }
+            _evaluate(gss, best, symbol);
+            gss.symbols[symbol].rule = gss.alternatives[best].rule;
+
+            if (gss.alternatives[gss.symbols[symbol].alternatives].next == size_t(-1))
+              return;
+            ++gss.ambiguity_count;
+            for (size_t alt = gss.symbols[symbol].alternatives; alt != size_t(-1); alt = gss.alternatives[alt].next)
+            {
+              if (alt != best)
+                _merge_alternative(gss, symbol, alt);
+            }
+          }
+
+          /// \brief Return true if the derivation \p a is preferred over \p b: the rule that comes first in the grammar,
+          /// and for the same rule, the one that has been reduced first (its children start later)
+          static bool _is_preferred(const gss_t &gss, size_t a, size_t b)
+          {
+            const typename gss_t::alternative &alt_a = gss.alternatives[a];
+            const typename gss_t::alternative &alt_b = gss.alternatives[b];
+            if (alt_a.rule->priority != alt_b.rule->priority)
+              return alt_a.rule->priority < alt_b.rule->priority;
+            for (size_t i = 1; i < alt_a.rule->size; ++i)
+            {
+              const size_t start_a = gss.symbols[gss.children[alt_a.children + i]].start;
+              const size_t start_b = gss.symbols[gss.children[alt_b.children + i]].start;
+              if (start_a != start_b)
+                return start_a > start_b;
+            }
+            return false;
+          }
+
+          /// \brief Call the attribute of a derivation, the result goes in \p dest
+          static void _evaluate(gss_t &gss, size_t alt, size_t dest)
+          {
+            const typename gss_t::alternative current = gss.alternatives[alt];
+            for (size_t i = 0; i < current.rule->size; ++i)
+              _resolve(gss, gss.children[current.children + i]);
+            current.rule->call(gss, &gss.children[current.children], dest, 1);
+          }
+
+          /// \brief Merge the value of another derivation with the value of \p symbol (only if SyntaxClass has a merge function for that type)
+          static void _merge_alternative(gss_t &gss, size_t symbol, size_t alt)
+          {
+            const size_t value_type = gss.symbols[symbol].value_type;
+            if (value_type == size_t(-1) || !value_ops::table[value_type].can_merge)
+              return;
+            const size_t other = gss.new_symbol(gss.symbols[symbol].type, gss.symbols[symbol].start);
+            _evaluate(gss, alt, other);
+            if (gss.symbols[other].value_type == value_type)
+              value_ops::table[value_type].merge(gss.symbols[symbol], gss.symbols[other]);
+          }
+
+          /// \brief Replace the value of \p symbol (already computed) by the value of the derivation \p alt, that is preferred.
+          /// The old value is merged into the new one (only if SyntaxClass has a merge function for that type)
+          static void _prefer_alternative(gss_t &gss, size_t symbol, size_t alt)
+          {
+            const size_t preferred = gss.new_symbol(gss.symbols[symbol].type, gss.symbols[symbol].start);
+            _evaluate(gss, alt, preferred);
+            const size_t value_type = gss.symbols[preferred].value_type;
+            if (value_type == size_t(-1))
+              return;
+            if (value_type == gss.symbols[symbol].value_type && value_ops::table[value_type].can_merge)
+              value_ops::table[value_type].merge(gss.symbols[preferred], gss.symbols[symbol]);
+            value_ops::table[value_type].transfer(gss.symbols[symbol], gss.symbols[preferred], 0);
+            gss.symbols[symbol].value_type = value_type;
+            gss.symbols[symbol].rule = gss.alternatives[alt].rule;
+          }
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1127409826163125531_3041895537__GLR_PARSER_HPP__*/
@@ -58,11 +58,23 @@ namespace neam
 
         using attribute = Attribute;
 
+        /// \brief True if the attribute needs the arena
+        static constexpr bool uses_arena = internal::attribute_takes_parameter<Attribute, arena &>::value;
+        /// \brief True if the attribute needs the line index
+        static constexpr bool uses_line_index = internal::attribute_takes_parameter<Attribute, const line_index &>::value;
+        /// \brief True if the attribute needs the user context (SyntaxClass::context_type)
+        static constexpr bool uses_user_context = internal::attribute_takes_parameter<Attribute, internal::user_context_t<SyntaxClass> &>::value
+                                                  || internal::attribute_takes_parameter<Attribute, const internal::user_context_t<SyntaxClass> &>::value;
+
+        /// \brief The number of parameters of the attribute that are taken from the production rule
+        static constexpr long arity = internal::attribute_arity<SyntaxClass, Attribute>::value;
+
         // This will trigger if the attribute has a different arity than the number of Tokens Or Rules specified for that production
-        static_assert((Attribute::arity <= 0 || Attribute::arity == sizeof...(TokensOrRules)), "number of parameter for the attribute is different from what can provide the production rule");
+        // (parameters provided by the parser, like an arena &, must be the first parameters of the function and are not accounted)
+        static_assert((arity <= 0 || arity == sizeof...(TokensOrRules)), "number of parameter for the attribute is different from what can provide the production rule");
 
         // This will trigger if the attribute require at least x parameters but less are provided by the production
-        static_assert((Attribute::arity >= 0 || (-Attribute::arity) <= sizeof...(TokensOrRules)), "attribute need to many parameters in production_rule");
+        static_assert((arity >= 0 || (-arity) <= sizeof...(TokensOrRules)), "attribute need to many parameters in production_rule");
       };
 
       /// \brief A set of production rule that shares the same "name"
@@ -86,10 +98,61 @@ namespace neam
 
         /// \brief The list of all possible return types
         using return_type_list = typename as_type_list::template for_each<forward_attr_ret_type>::template remove_if<is_void>::make_unique;
+
+        /// \brief True if one of the attributes needs the arena
+        static constexpr bool uses_arena = internal::any_of(ProductionRules::uses_arena...);
+        /// \brief True if one of the attributes needs the line index
+        static constexpr bool uses_line_index = internal::any_of(ProductionRules::uses_line_index...);
+        /// \brief True if one of the attributes needs the user context
+        static constexpr bool uses_user_context = internal::any_of(ProductionRules::uses_user_context...);
       };
 
+      /// \brief The associativity of a precedence level
+      enum class associativity
+      {
+        left,   ///< \brief a + b + c is (a + b) + c
+        right,  ///< \brief a ^ b ^ c is a ^ (b ^ c)
+      };
+
+      namespace internal
+      {
+        /// \brief A precedence level: the terminals that have the same precedence
+        template<typename SyntaxClass, associativity Associativity, typename SyntaxClass::token_type::type_t... Tokens>
+        struct precedence_level
+        {
+          precedence_level() = delete;
+
+          static constexpr bool is_precedence_level = true;
+          static constexpr associativity assoc = Associativity;
+          using tokens = ct::type_list<embed::embed<typename SyntaxClass::token_type::type_t, Tokens>...>;
+
+          // not a production_rule_set
+          static constexpr bool uses_arena = false;
+          static constexpr bool uses_line_index = false;
+          static constexpr bool uses_user_context = false;
+        };
+
+        template<typename X> struct is_precedence_level { static constexpr bool value = false; };
+        template<typename SyntaxClass, associativity Associativity, typename SyntaxClass::token_type::type_t... Tokens>
+        struct is_precedence_level<precedence_level<SyntaxClass, Associativity, Tokens...>> { static constexpr bool value = true; };
+      } // namespace internal
+
+      /// \brief Declare a precedence level of left-associative terminals (like the %left of yacc)
+      /// The precedence levels are given to the grammar (with the production_rule_set), the first one having the lowest precedence.
+      /// A production rule has the precedence of its last terminal that has one.
+      /// When the parser could either reduce a rule or shift a terminal, it shifts if the terminal has a higher precedence than the rule
+      /// (or the same precedence and is right-associative), else it reduces. Without precedence, it reduces.
+      template<typename SyntaxClass, typename SyntaxClass::token_type::type_t... Tokens>
+      using left_associative = internal::precedence_level<SyntaxClass, associativity::left, Tokens...>;
+
+      /// \brief Declare a precedence level of right-associative terminals (like the %right of yacc)
+      /// \see left_associative
+      template<typename SyntaxClass, typename SyntaxClass::token_type::type_t... Tokens>
+      using right_associative = internal::precedence_level<SyntaxClass, associativity::right, Tokens...>;
+
       /// \brief The (parser) grammar
       /// The grammar class generate the LR(1) state-machine at compile-time
+      /// \param ProductionRuleSets The production_rule_sets, and the precedence levels (left_associative / right_associative) if any
       template<typename SyntaxClass, typename SyntaxClass::token_type::type_t StartRule, typename... ProductionRuleSets>
       class grammar
       {
@@ -103,8 +166,28 @@ namespace neam
           static constexpr type_t start_rule = StartRule;
 
 
-          using as_type_list = ct::type_list<ProductionRuleSets...>;
-          using non_terminal_list = ct::type_list<embed::embed<type_t, ProductionRuleSets::rule_name>...>; // in order
+          using as_type_list = typename ct::type_list<ProductionRuleSets...>::template remove_if<internal::is_precedence_level>;
+
+          template<typename X> using get_rule_name = embed::embed<type_t, X::rule_name>;
+          using non_terminal_list = typename as_type_list::template direct_for_each<get_rule_name>; // in order
+
+          /// \brief The precedence levels, from the lowest to the highest
+          using precedence_list = typename ct::type_list<ProductionRuleSets...>::template filter_by<internal::is_precedence_level>;
+
+          /// \brief The precedence of a terminal (0 if it has none, precedence_list::size for the highest) and its associativity
+          template<type_t Token>
+          struct token_precedence
+          {
+            template<typename X> struct has_token { static constexpr bool value = ct::is_in_list<typename X::tokens, embed::embed<type_t, Token>>::value; };
+            static constexpr long index = precedence_list::template find_if<has_token>::index;
+
+            template<long Index, bool = false> struct _switch { static constexpr associativity assoc = precedence_list::template get_type<Index>::assoc; };
+            template<bool X> struct _switch<-1, X> { static constexpr associativity assoc = associativity::left; };
+
+            static constexpr size_t value = size_t(index + 1);
+            static constexpr associativity assoc = _switch<index>::assoc;
+            static constexpr bool is_right_associative = (assoc == associativity::right);
+          };
 
           template<typename X> struct forward_return_type_list { using type = typename X::return_type_list; };
 
@@ -115,6 +198,13 @@ namespace neam
             ct::type_list<typename syntax_class::token_type, type_t>
           >::type_list::make_unique;
 
+          /// \brief True if one of the attributes needs an arena (and thus the parser must be used with a context)
+          static constexpr bool uses_arena = internal::any_of(ProductionRuleSets::uses_arena...);
+          /// \brief True if one of the attributes needs the line index (and thus the parser must be used with a context)
+          static constexpr bool uses_line_index = internal::any_of(ProductionRuleSets::uses_line_index...);
+          /// \brief True if one of the attributes needs the user context (and thus it must be given to the parser)
+          static constexpr bool uses_user_context = internal::any_of(ProductionRuleSets::uses_user_context...);
+
         private: // check
           template<typename RS> struct is_start_rule { constexpr static bool value = (RS::rule_name == start_rule); };
           static constexpr long start_index = as_type_list::template find_if<is_start_rule>::index;
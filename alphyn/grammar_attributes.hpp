@@ -31,6 +31,7 @@
 # define __N_17919225691272920340_1595232666__GRAMMAR_ATTRIBUTES_HPP__
 
 #include <utility>
+#include <type_traits>
 #include <tools/embed.hpp>
 
 namespace neam
@@ -136,6 +137,88 @@ namespace neam
         using return_type = void;           // not accounted
         static constexpr long arity = 0;    // not accounted
       };
+
+      class arena; // see arena.hpp
+      class line_index; // see line_index.hpp
+
+      // // injected parameters // //
+      // Attribute functions may ask for things the parser has (like the arena or the user context) by having them as their first parameters.
+      // Those parameters are not taken from the production rule.
+
+      namespace internal
+      {
+        constexpr bool any_of() { return false; }
+        template<typename... Bools>
+        constexpr bool any_of(bool b, Bools... bs) { return b || any_of(bs...); }
+        constexpr long count_of() { return 0; }
+        template<typename... Bools>
+        constexpr long count_of(bool b, Bools... bs) { return (b ? 1 : 0) + count_of(bs...); }
+
+        template<typename...> struct make_void { using type = void; };
+
+        /// \brief Used as the user context type when the SyntaxClass doesn't define one (it will never match a parameter)
+        struct no_user_context {};
+
+        /// \brief Retrieve SyntaxClass::context_type (no_user_context if there's none)
+        template<typename SyntaxClass, typename = void>
+        struct user_context_type
+        {
+          using type = no_user_context;
+        };
+        template<typename SyntaxClass>
+        struct user_context_type<SyntaxClass, typename make_void<typename SyntaxClass::context_type>::type>
+        {
+          using type = typename SyntaxClass::context_type;
+        };
+        template<typename SyntaxClass>
+        using user_context_t = typename user_context_type<SyntaxClass>::type;
+
+        /// \brief Tell whether a parameter of an attribute function is provided by the parser (and not taken from the production rule)
+        /// By default, only (const) references to the user context are injected
+        template<typename SyntaxClass, typename Param>
+        struct is_injected_parameter : public std::integral_constant<bool,
+          std::is_lvalue_reference<Param>::value && std::is_same<std::remove_const_t<std::remove_reference_t<Param>>, user_context_t<SyntaxClass>>::value> {};
+        template<typename SyntaxClass>
+        struct is_injected_parameter<SyntaxClass, arena &> : public std::true_type {};
+        template<typename SyntaxClass>
+        struct is_injected_parameter<SyntaxClass, const line_index &> : public std::true_type {};
+
+        /// \brief Count the leading injected parameters (injected parameters must come first, see attribute_arity)
+        template<typename SyntaxClass, typename... Params>
+        struct injected_parameter_count
+        {
+          static constexpr long value = 0;
+        };
+        template<typename SyntaxClass, typename Param, typename... Params>
+        struct injected_parameter_count<SyntaxClass, Param, Params...>
+        {
+          static constexpr long value = is_injected_parameter<SyntaxClass, Param>::value ? 1 + injected_parameter_count<SyntaxClass, Params...>::value : 0;
+        };
+
+        /// \brief The arity of the attribute, from the production rule point of view (injected parameters are not accounted)
+        template<typename SyntaxClass, typename Attribute>
+        struct attribute_arity
+        {
+          static constexpr long value = Attribute::arity;
+        };
+        template<typename SyntaxClass, typename Ret, typename... Args, Ret (*Function)(Args...)>
+        struct attribute_arity<SyntaxClass, attribute<Ret (*)(Args...), Function>>
+        {
+          // If you see this, your attribute has a parameter provided by the parser (arena &, const line_index & or a reference to the user context)
+          // after a parameter taken from the production rule. Put them first.
+          static_assert(count_of(is_injected_parameter<SyntaxClass, Args>::value...) == injected_parameter_count<SyntaxClass, Args...>::value,
+                        "the injected parameters of an attribute must come before the other parameters");
+
+          static constexpr long value = long(sizeof...(Args)) - injected_parameter_count<SyntaxClass, Args...>::value;
+        };
+
+        /// \brief Tell if an attribute function has a parameter of type Param
+        template<typename Attribute, typename Param>
+        struct attribute_takes_parameter : public std::false_type {};
+        template<typename Ret, typename... Args, Ret (*Function)(Args...), typename Param>
+        struct attribute_takes_parameter<attribute<Ret (*)(Args...), Function>, Param>
+          : public std::integral_constant<bool, any_of(std::is_same<Args, Param>::value...)> {};
+      } // namespace internal
     } // namespace alphyn
   } // namespace ct
 } // namespace neam
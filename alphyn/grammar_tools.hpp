@@ -501,6 +501,89 @@ namespace neam
           using state = State; ///< \brief The state linked by this edge
         };
 
+        /// \brief The precedence of a production rule: the one of its last terminal that has one (0 if none)
+        template<typename SyntaxClass, typename PRW>
+        struct _rule_precedence
+        {
+          using grammar = typename SyntaxClass::grammar;
+          template<typename X> struct has_precedence { static constexpr bool value = (grammar::template token_precedence<X::value>::value != 0); };
+
+          using terminals = typename PRW::as_type_list::template filter_by<has_precedence>;
+          template<long Size, bool = false>
+          struct last { static constexpr size_t value = grammar::template token_precedence<terminals::template get_type<Size - 1>::value>::value; };
+          template<bool X> struct last<0, X> { static constexpr size_t value = 0; };
+
+          static constexpr size_t value = last<terminals::size>::value;
+        };
+
+        /// \brief The terminals that the final rules of a state reduce because they have won a conflict against a shift with the precedence
+        /// levels (see _resolve_precedence). The parser never sees those conflicts as it reduces first, but the GLR parser would fork on them.
+        template<typename SyntaxClass, typename FinalRules>
+        struct _reduced_by_precedence
+        {
+          using grammar = typename SyntaxClass::grammar;
+          template<typename X> struct has_precedence { static constexpr bool value = (grammar::template token_precedence<X::value>::value != 0); };
+
+          template<typename PRW>
+          struct apply
+          {
+            using type = typename std::conditional
+            <
+              _rule_precedence<SyntaxClass, PRW>::value != 0,
+              typename PRW::follow_set::template filter_by<has_precedence>,
+              ct::type_list<>
+            >::type;
+          };
+          using list = typename FinalRules::template for_each<apply>::flatten::make_unique;
+        };
+
+        /// \brief Resolve the shift/reduce conflicts of a state with the precedence levels of the grammar (see left_associative).
+        /// The terminals that have to be shifted are removed from the follow sets of the final rules: the parser only reduces a rule
+        /// when the next token is in its follow set, and tries to shift it otherwise.
+        template<typename SyntaxClass, typename Rules, typename TransitionNames, bool HasPrecedence = (SyntaxClass::grammar::precedence_list::size != 0)>
+        struct _resolve_precedence
+        {
+          using list = Rules;
+        };
+
+        template<typename SyntaxClass, typename Rules, typename TransitionNames>
+        struct _resolve_precedence<SyntaxClass, Rules, TransitionNames, true>
+        {
+          using grammar = typename SyntaxClass::grammar;
+
+          template<typename PRW, bool IsFinal = PRW::is_final>
+          struct resolve { using type = ct::type_list<PRW>; }; // non-final rules: nothing to do
+
+          template<typename PRW>
+          struct resolve<PRW, true>
+          {
+            static constexpr size_t rule_precedence = _rule_precedence<SyntaxClass, PRW>::value;
+
+            template<typename T>
+            struct is_reduced
+            {
+              using token_precedence = typename grammar::template token_precedence<T::value>;
+              static constexpr bool is_shifted = ct::is_in_list<TransitionNames, T>::value && rule_precedence != 0 && token_precedence::value != 0
+                                                 && (token_precedence::value > rule_precedence
+                                                     || (token_precedence::value == rule_precedence && token_precedence::is_right_associative));
+              static constexpr bool value = !is_shifted;
+            };
+
+            using follow_set = typename PRW::follow_set::template filter_by<is_reduced>;
+
+            // a rule that has lost all its follow set can't be reduced anymore (only the start rule has an empty follow set)
+            using type = typename std::conditional
+            <
+              (PRW::follow_set::size != 0 && follow_set::size == 0),
+              ct::type_list<>,
+              ct::type_list<typename PRW::template set_follow_set<follow_set>>
+            >::type;
+          };
+
+          template<typename PRW> using resolve_rule = resolve<PRW>;
+          using list = typename Rules::template for_each<resolve_rule>::flatten;
+        };
+
         /// \brief An automaton's (quite raw) state.
         /// \note The compiler can choose to have a lazy evaluation of the graph, but as_type_list forces it to create the whole graph
         template<typename SyntaxClass, typename ClosureResultList>
@@ -647,9 +730,9 @@ namespace neam
           // type is ct::type_list of prod_rule_wrapper
           using state_rules = ClosureResultList;
 
-          // final rules (rules that doesn't have a possible transition)
+          // final rules (rules that doesn't have a possible transition), with the precedence conflicts resolved
           // type is ct::type_list of prod_rule_wrapper
-          using final_rules = typename ClosureResultList::template filter_by<is_a_final_rule>;
+          using final_rules = typename _resolve_precedence<SyntaxClass, ClosureResultList, transition_names>::list::template filter_by<is_a_final_rule>;
 
           // non-final rules (rules that does have a possible transition)
           // type is ct::type_list of prod_rule_wrapper
@@ -658,13 +741,262 @@ namespace neam
           // export the graph as a ct::type_list<...>
           using as_type_list = get_list<ct::type_list<>>;
         };
+
+        /// \brief The core of a prod_rule_wrapper: the rule and the position, without the follow set
+        template<typename PRW>
+        using prw_core = typename PRW::template set_follow_set<ct::type_list<>>;
+
+        /// \brief Merge the states of a (canonical) LR(1) automaton that have the same core (LALR(1))
+        /// The follow sets of the items of the merged states are the union of the follow sets of the items of the original states.
+        /// A merge can introduce reduce/reduce (or shift/reduce) conflicts. The states whose merge would do that are kept as they are,
+        /// and so are the states that lead to them (a merged state can't go to an unmerged group: its states would each go to a different one).
+        /// The rest is merged.
+        template<typename SyntaxClass, typename CanonicalList>
+        struct _lalr
+        {
+          template<typename State>
+          using core = typename State::state_rules::template direct_for_each<prw_core>;
+
+          // the items of a state are unique, so having the same size and every item of A in B is enough
+          template<typename A, typename B>
+          struct is_same_core
+          {
+            template<typename X> struct is_not_in_b { static constexpr bool value = !ct::is_in_list<core<B>, X>::value; };
+            static constexpr bool value = (core<A>::size == core<B>::size) && (core<A>::template filter_by<is_not_in_b>::size == 0);
+          };
+
+          template<typename PRW> struct is_a_final_rule { static constexpr bool value = PRW::is_final; };
+
+          /// \brief The tokens of the follow sets of the final rules of Rules that are also in TransitionNames or in the follow sets of other final rules
+          template<typename Rules, typename TransitionNames>
+          struct conflict_tokens
+          {
+            // the conflicts resolved by the precedence levels are not conflicts
+            using final_rules = typename _resolve_precedence<SyntaxClass, Rules, TransitionNames>::list::template filter_by<is_a_final_rule>;
+
+            template<typename FR>
+            struct of_rule
+            {
+              template<typename X> struct is_other { static constexpr bool value = !std::is_same<X, FR>::value; };
+              using other_follow_sets = typename final_rules::template filter_by<is_other>::template direct_for_each<forward_lookahead>::flatten;
+              template<typename T> struct is_conflicting
+              {
+                static constexpr bool value = ct::is_in_list<TransitionNames, T>::value || ct::is_in_list<other_follow_sets, T>::value;
+              };
+              using type = typename FR::follow_set::template filter_by<is_conflicting>;
+            };
+
+            using list = typename final_rules::template for_each<of_rule>::flatten::make_unique;
+          };
+
+          /// \brief The states that have the same core as State
+          template<typename State>
+          struct group
+          {
+            template<typename X> using has_same_core = is_same_core<State, X>;
+            using same_core_states = typename CanonicalList::template filter_by<has_same_core>;
+
+            // the first one (in the order of the canonical automaton) represents all of them
+            using representative = typename same_core_states::front;
+
+            template<typename X> using get_rules = typename X::state_rules;
+            using all_rules = typename same_core_states::template direct_for_each<get_rules>::flatten;
+
+            template<typename PRW>
+            struct merge_rule
+            {
+              template<typename X> using has_same_core = std::is_same<prw_core<X>, prw_core<PRW>>;
+              using type = typename PRW::template set_follow_set
+              <
+                typename all_rules::template filter_by<has_same_core>::template direct_for_each<forward_lookahead>::flatten::make_unique
+              >;
+            };
+
+            // the rules of State, with the follow sets of the whole group
+            using merged_rules = typename State::state_rules::template for_each<merge_rule>;
+
+            // as the merged follow sets contains the original ones, having the same number of conflicting tokens means having the same conflicts
+            static constexpr bool introduces_conflicts = conflict_tokens<merged_rules, typename State::transition_names>::list::size
+                                                         != conflict_tokens<typename State::state_rules, typename State::transition_names>::list::size;
+          };
+
+          template<typename X> struct introduces_conflicts { static constexpr bool value = group<X>::introduces_conflicts; };
+          template<typename X> struct has_conflicts { static constexpr bool value = (group<X>::same_core_states::template filter_by<introduces_conflicts>::size != 0); };
+          template<typename X> struct has_several_states { static constexpr bool value = (group<X>::same_core_states::size > 1); };
+
+          template<typename X> struct is_group_representative { static constexpr bool value = std::is_same<typename group<X>::representative, X>::value; };
+          using group_representatives = typename CanonicalList::template filter_by<is_group_representative>;
+
+          /// \brief Add to Kept (a list of group representatives) the groups that have a conflict or that have an edge to a group of Kept
+          template<typename Kept>
+          struct keep_step
+          {
+            template<typename Edge> struct leads_to_kept { static constexpr bool value = ct::is_in_list<Kept, typename group<typename Edge::state>::representative>::value; };
+            template<typename X> struct reaches_kept { static constexpr bool value = (X::edges::template filter_by<leads_to_kept>::size != 0); };
+            template<typename R>
+            struct must_keep
+            {
+              static constexpr bool value = ct::is_in_list<Kept, R>::value || has_conflicts<R>::value
+                                            || (group<R>::same_core_states::template filter_by<reaches_kept>::size != 0);
+            };
+            using type = typename group_representatives::template filter_by<must_keep>;
+          };
+          template<typename Kept, bool Done = false>
+          struct keep_fixpoint
+          {
+            using next = typename keep_step<Kept>::type;
+            using type = typename keep_fixpoint<next, next::size == Kept::size>::type;
+          };
+          template<typename Kept>
+          struct keep_fixpoint<Kept, true>
+          {
+            using type = Kept;
+          };
+
+          /// \brief The representatives of the groups that aren't merged
+          using kept_groups = typename keep_fixpoint<ct::type_list<>>::type;
+
+          /// \brief The merge of all the states that have the same core as State (or State itself, if its group isn't merged)
+          template<typename State>
+          struct merge
+          {
+            static constexpr bool is_kept = ct::is_in_list<kept_groups, typename group<State>::representative>::value;
+
+            using representative = typename std::conditional<is_kept, State, typename group<State>::representative>::type;
+            using state_rules = typename std::conditional<is_kept, typename State::state_rules, typename group<State>::merged_rules>::type;
+          };
+
+          template<typename X> struct is_representative { static constexpr bool value = std::is_same<typename merge<X>::representative, X>::value; };
+
+          /// \brief true if every state that has the same core as another one is merged (no merge introduces a conflict)
+          static constexpr bool can_merge = (kept_groups::template filter_by<has_several_states>::size == 0);
+        };
+
+        /// \brief A state of the LALR(1) automaton. It has the same interface as _state (for what the parsers use)
+        /// \param State The state of the canonical automaton that represents this state
+        template<typename SyntaxClass, typename CanonicalList, typename State>
+        struct _lalr_state
+        {
+          using lalr = _lalr<SyntaxClass, CanonicalList>;
+
+          template<typename PRW> struct is_a_final_rule { static constexpr bool value = PRW::is_final; };
+
+          // the edges lead to the merged states
+          template<typename Edge>
+          using edge_mapper = _edge<SyntaxClass, Edge::name, _lalr_state<SyntaxClass, CanonicalList, typename lalr::template merge<typename Edge::state>::representative>>;
+
+          template<typename X>
+          using to_lalr_state = _lalr_state<SyntaxClass, CanonicalList, X>;
+
+          // // public interface below: // //
+
+          // the state of the canonical LR(1) automaton
+          using canonical_state = State;
+
+          // the edges to other states (a ct::type_list of type _edge<>)
+          using edges = typename State::edges::template direct_for_each<edge_mapper>;
+
+          // the productions rules of the current state (with the merged follow sets)
+          using state_rules = typename lalr::template merge<State>::state_rules;
+
+          // final rules (rules that doesn't have a possible transition), with the precedence conflicts resolved
+          using final_rules = typename _resolve_precedence<SyntaxClass, state_rules, typename State::transition_names>::list::template filter_by<is_a_final_rule>;
+
+          // non-final rules (rules that does have a possible transition)
+          using non_final_rules = typename state_rules::template remove_if<is_a_final_rule>;
+
+          // export the graph as a ct::type_list<...> (the initial state of the canonical automaton is its own representative, so it stays the first)
+          using as_type_list = typename CanonicalList::template filter_by<lalr::template is_representative>::template direct_for_each<to_lalr_state>;
+        };
+
+        /// \brief Tell if a state has a default reduction: a single final rule and nothing to shift.
+        /// In that case, whatever the next token is, the only thing the state can do is to reduce that rule:
+        /// there's no need to look at the next token (if it's wrong, the error will be found when shifting it).
+        /// The start rule (that has an empty follow set) is excluded, as it has to check that there's nothing left.
+        template<typename SyntaxClass, typename State>
+        struct _default_reduction
+        {
+          template<typename Edge> struct is_a_shift { static constexpr bool value = _is_terminal<SyntaxClass, Edge::name>::value; };
+
+          template<typename FinalRules, bool HasOneRule>
+          struct _switch
+          {
+            static constexpr bool value = false;
+            using rule = void;
+          };
+          template<typename FinalRules>
+          struct _switch<FinalRules, true>
+          {
+            using rule = typename FinalRules::front;
+            static constexpr bool value = (rule::follow_set::size != 0);
+          };
+
+          using result = _switch
+          <
+            typename State::final_rules,
+            State::final_rules::size == 1 && State::edges::template filter_by<is_a_shift>::size == 0
+          >;
+
+          /// \brief true if the state has a default reduction
+          static constexpr bool value = result::value;
+          /// \brief The rule to reduce (a prod_rule_wrapper), if value is true
+          using rule = typename result::rule;
+        };
+
+        /// \brief The tokens a state has more than one thing to do with: the tokens that are in the follow sets of several final rules,
+        /// or that can be both reduced and shifted. The conflicts that the precedence levels have resolved in favor of a reduction are
+        /// not counted (the ones resolved in favor of a shift are already out of the follow sets, see _resolve_precedence).
+        template<typename SyntaxClass, typename State>
+        struct _conflict_tokens
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using reduced_by_precedence = typename _reduced_by_precedence<SyntaxClass, typename State::final_rules>::list;
+
+          template<typename Edge> struct is_a_shift { static constexpr bool value = _is_terminal<SyntaxClass, Edge::name>::value; };
+          template<typename Edge> using edge_name = embed::embed<type_t, Edge::name>;
+          template<typename T> struct is_shifted { static constexpr bool value = !ct::is_in_list<reduced_by_precedence, T>::value; };
+          template<typename PRW> struct get_follow_set { using type = typename PRW::follow_set; };
+          template<typename PRW> struct has_empty_follow_set { static constexpr bool value = (PRW::follow_set::size == 0); };
+
+          using shifts = typename State::edges::template filter_by<is_a_shift>::template direct_for_each<edge_name>::template filter_by<is_shifted>;
+          // every token that can be shifted or reduced, once per action
+          using actions = typename State::final_rules::template for_each<get_follow_set>::flatten::template append_list<shifts>;
+          template<typename T> struct is_same_token { template<typename X> using apply = std::is_same<T, X>; };
+          template<typename T> struct has_several_actions { static constexpr bool value = (actions::template filter_by<is_same_token<T>::template apply>::size > 1); };
+
+          /// \brief The tokens (a list of embed::embed<type_t, Token>)
+          using list = typename actions::template filter_by<has_several_actions>::make_unique;
+          /// \brief true if the end of the input is a conflict too (the start rule, that is reduced there, isn't the only thing to do)
+          static constexpr bool at_end = State::final_rules::template filter_by<has_empty_follow_set>::size != 0
+                                         && (State::final_rules::size > 1 || shifts::size != 0);
+        };
+
+        /// \brief The id of a production rule: its index in the grammar, the rules of all the production_rule_sets being counted in order
+        /// (the first rule of the first set is 0). A rule is identified by its name, its elements and its attribute.
+        template<typename SyntaxClass, typename SyntaxClass::token_type::type_t Name, typename TypeList, typename Attribute>
+        struct _rule_id
+        {
+          using grammar = typename SyntaxClass::grammar;
+
+          template<typename RS> struct is_rule_set { static constexpr bool value = (RS::rule_name == Name); };
+          static constexpr long set_index = grammar::as_type_list::template find_if<is_rule_set>::index;
+          template<typename PR> struct is_rule { static constexpr bool value = std::is_same<typename PR::as_type_list, TypeList>::value && std::is_same<typename PR::attribute, Attribute>::value; };
+          static constexpr long rule_index = grammar::as_type_list::template get_type<set_index>::as_type_list::template find_if<is_rule>::index;
+
+          // the number of rules in the sets before the set SetIndex
+          template<long SetIndex, bool = false>
+          struct offset { static constexpr size_t value = grammar::as_type_list::template get_type<SetIndex - 1>::as_type_list::size + offset<SetIndex - 1>::value; };
+          template<bool X> struct offset<0, X> { static constexpr size_t value = 0; };
+
+          static constexpr size_t value = offset<set_index>::value + size_t(rule_index);
+        };
       } // namespace internal
 
       /// \brief You may not use this class directly, but if we have to sort things in this file in the order of you should not use them directly, this class comes last
       /// Its only purpose is to be an "interface" to "easily" manipulate the grammar type of SyntaxClass
       /// I want it to be fully compile-time, so there's mostly usings that forward to some other constructs
       ///
-      /// It has: terminal / non-terminal checking, first and follow, closure, get_transition_list and lr1_automaton
+      /// It has: terminal / non-terminal checking, first and follow, closure, get_transition_list, lr1_automaton and lalr1_merge
       template<typename SyntaxClass>
       struct grammar_tools
       {
@@ -694,10 +1026,37 @@ namespace neam
         /// It starts from the initial non-terminal (as defined by the grammar)
         using lr1_automaton = internal::_state<SyntaxClass, closure_la<SyntaxClass::grammar::start_rule, ct::type_list<>>>;
 
+        /// \brief The LALR(1) automaton: the states of the LR(1) automaton that have the same core are merged.
+        /// (it's a struct so that nothing is computed if it isn't used)
+        struct lalr1_merge
+        {
+          /// \brief true if all the states of lr1_automaton that have the same core can be merged without introducing conflicts
+          /// (if it's false, the states whose merge would introduce one are kept as they are, and so are the states that lead to them)
+          static constexpr bool can_merge = internal::_lalr<SyntaxClass, typename lr1_automaton::as_type_list>::can_merge;
+
+          /// \brief The LALR(1) automaton (only partially merged if can_merge is false)
+          using automaton = internal::_lalr_state<SyntaxClass, typename lr1_automaton::as_type_list, lr1_automaton>;
+        };
+
         /// \brief Check if T is a terminal (token-type) or a non-terminal (production rule)
         template<type_t T> using is_terminal = internal::_is_terminal<SyntaxClass, T>;
         /// \brief Check if T is a terminal (token-type) or a non-terminal (production rule)
         template<type_t NT> using is_non_terminal = internal::_is_non_terminal<SyntaxClass, NT>;
+
+        /// \brief Check if a state (of lr1_automaton or lalr1_merge::automaton) reduces its rule without looking at the next token
+        template<typename State> using has_default_reduction = internal::_default_reduction<SyntaxClass, State>;
+
+        /// \brief The tokens for which a state (of lr1_automaton or lalr1_merge::automaton) has more than one thing to do (see stop_on_conflicts)
+        template<typename State> using conflict_tokens = internal::_conflict_tokens<SyntaxClass, State>;
+
+        /// \brief The id of the production rule \p Index of the production_rule_set \p NT (see build_syntax_tree)
+        template<type_t NT, size_t Index = 0>
+        using rule_id = std::integral_constant<size_t, internal::_rule_id
+        <
+          SyntaxClass, NT,
+          typename internal::wrap_non_terminal<SyntaxClass, NT>::type::template get_type<Index>::as_type_list,
+          typename internal::wrap_non_terminal<SyntaxClass, NT>::type::template get_type<Index>::attribute
+        >::value>;
       };
     } // namespace alphyn
   } // namespace ct
@@ -47,14 +47,15 @@ namespace neam
 
         public:
           /// \brief constructor
-          constexpr lexem_list(const char *_str, size_t _start_index)
-            : str(_str), start_index(_start_index), end_index(-1),
-              token(lexer_type::get_token(str, start_index, end_index))
+          /// \param _type_only If true, the values of the tokens may not be computed (only their types and ranges are, see syntactic_unit)
+          constexpr lexem_list(const char *_str, size_t _start_index, bool _type_only = false)
+            : str(_str), start_index(_start_index), end_index(-1), type_only(_type_only),
+              token(type_only ? lexer_type::get_type_only_token(str, start_index, end_index) : lexer_type::get_token(str, start_index, end_index))
           {}
 
           /// \brief copy constructor (no move, 'cause that does not mean anything)
           constexpr lexem_list(const lexem_list &o)
-            : str(o.str), start_index(o.start_index), end_index(o.end_index), token(o.token)
+            : str(o.str), start_index(o.start_index), end_index(o.end_index), type_only(o.type_only), token(o.token)
           {}
 
           /// \brief Return the token of the current lexem
@@ -66,9 +67,13 @@ namespace neam
           /// \brief Return the next lexem_list entry
           constexpr lexem_list get_next() const
           {
-            return lexem_list(str, ((end_index == -1) ? start_index : end_index));
+            return lexem_list(str, ((end_index == -1) ? start_index : end_index), type_only);
           }
 
+          /// \brief Return the index in the string where the lexer started to look for the current token
+          /// (it may be before the start of the token, as things like white spaces may be skipped)
+          constexpr size_t get_start_index() const { return start_index; }
+
           /// \brief Return true if the current entry is the last entry of the list
           constexpr bool is_last() const
           {
@@ -79,6 +84,7 @@ namespace neam
           const char *str;
           size_t start_index;
           long end_index;
+          bool type_only;
 
           token_type token;
       };
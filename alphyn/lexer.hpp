@@ -82,10 +82,11 @@ namespace neam
 
           /// \brief The entry point of the lexer.
           /// It return a lazy-constructed lexem_list (it only scans one token at a time, when needed)
+          /// \param type_only If true, the values of the tokens may not be computed (see syntactic_unit)
           /// \see ct_lexem_list
-          static constexpr inline lazy_lexem_list get_lazy_lexer(const char *s, size_t start_index = 0)
+          static constexpr inline lazy_lexem_list get_lazy_lexer(const char *s, size_t start_index = 0, bool type_only = false)
           {
-            return lazy_lexem_list(s, start_index);
+            return lazy_lexem_list(s, start_index, type_only);
           }
 
           /// \brief Return a single token, updates end_index (to either -1 if something fails, or the new end_index)
@@ -95,6 +96,13 @@ namespace neam
             return syntax_type::template get_token<SyntaxClass>(s, skip(s, start_index), end_index);
           }
 
+          /// \brief Return a single token whose value may not be computed, updates end_index (to either -1 if something fails, or the new end_index)
+          /// \note You may never call this function
+          static constexpr inline token_type get_type_only_token(const char *s, long start_index, long &end_index)
+          {
+            return syntax_type::template get_type_only_token<SyntaxClass>(s, skip(s, start_index), end_index);
+          }
+
           /// \brief Return a single token
           /// \note You may never call this function
           static constexpr inline token_type get_token(const char *s, long start_index)
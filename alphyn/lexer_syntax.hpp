@@ -43,7 +43,10 @@ namespace neam
       /// \param Function is the binding function to call when transforming the string into a token.
       ///                 it takes as parameters the string to tokenize, the start index and the end index.
       ///                 it returns the generated token.
-      template<typename Matcher, typename TokenType, TokenType(*Function)(const char *, size_t, size_t)>
+      /// \param TypeOnlyFunction is the function called instead of Function when only the type of the token matters (see parser::recognize()).
+      ///                 If Function computes a value, giving here a function that doesn't (like token::generate_token_with_type<>)
+      ///                 makes the lexer faster in that case.
+      template<typename Matcher, typename TokenType, TokenType(*Function)(const char *, size_t, size_t), TokenType(*TypeOnlyFunction)(const char *, size_t, size_t) = Function>
       struct syntactic_unit
       {
         syntactic_unit() = delete;
@@ -61,6 +64,12 @@ namespace neam
         {
           return Function(s, start_index, end_index);
         }
+
+        /// \brief Generate a token from a range in s, when only its type (and its range) matters
+        constexpr static inline TokenType generate_type_only_token(const char *s, long start_index, long end_index)
+        {
+          return TypeOnlyFunction(s, start_index, end_index);
+        }
       };
 
       /// \brief The syntax, as seen by the parser
@@ -75,7 +84,14 @@ namespace neam
           template<typename SyntaxClass>
           inline static constexpr typename SyntaxClass::token_type get_token(const char *s, long start_index, long &end_index)
           {
-            return get_token_rec<SyntaxClass, Units...>(s, start_index, end_index);
+            return get_token_rec<SyntaxClass, false, Units...>(s, start_index, end_index);
+          }
+
+          /// \brief Generate one token whose value may not be computed (only its type and its range matter), advancing end_index
+          template<typename SyntaxClass>
+          inline static constexpr typename SyntaxClass::token_type get_type_only_token(const char *s, long start_index, long &end_index)
+          {
+            return get_token_rec<SyntaxClass, true, Units...>(s, start_index, end_index);
           }
 
           /// \brief Generate one token
@@ -83,7 +99,7 @@ namespace neam
           inline static constexpr typename SyntaxClass::token_type get_token(const char *s, long start_index)
           {
             long end_index = 0;
-            return get_token_rec<SyntaxClass, Units...>(s, start_index, end_index);
+            return get_token_rec<SyntaxClass, false, Units...>(s, start_index, end_index);
           }
 
           /// \brief Get the end index
@@ -95,17 +111,17 @@ namespace neam
 
         private:
           /// \brief Recursively matches rules until something works or everything fails.
-          template<typename SyntaxClass, typename ItUnit, typename... ItUnits>
+          template<typename SyntaxClass, bool TypeOnly, typename ItUnit, typename... ItUnits>
           inline static constexpr typename SyntaxClass::token_type get_token_rec(const char *s, long start_index, long &end_index)
           {
             end_index = ItUnit::match(s, start_index);
             if (end_index != -1)
-              return ItUnit::generate_token(s, start_index, end_index);
-            return get_token_rec<SyntaxClass, ItUnits...>(s, start_index, end_index);
+              return TypeOnly ? ItUnit::generate_type_only_token(s, start_index, end_index) : ItUnit::generate_token(s, start_index, end_index);
+            return get_token_rec<SyntaxClass, TypeOnly, ItUnits...>(s, start_index, end_index);
           }
 
           /// \brief Called when everything else fails: it returns an invalid token
-          template<typename SyntaxClass>
+          template<typename SyntaxClass, bool TypeOnly>
           inline static constexpr typename SyntaxClass::token_type get_token_rec(const char *s, long start_index, long &end_index)
           {
             end_index = -1;
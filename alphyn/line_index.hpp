@@ -0,0 +1,211 @@
+//
+// file : line_index.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2905113541164729360_2470193873__LINE_INDEX_HPP__
+# define __N_2905113541164729360_2470193873__LINE_INDEX_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      /// \brief A position in a text (both start at 1, the column is in bytes)
+      struct text_position
+      {
+        size_t line;
+        size_t column;
+      };
+
+      /// \brief Find the line and the column of an offset in a string, without having the lexer count the lines.
+      /// The index is built lazily, on the first lookups, and only up to the offsets that are looked up: for each block of 4KB it keeps
+      /// the number of '\n' before the block (found 64 bytes at a time with SIMD, as a bitmap that is popcount-ed).
+      /// A lookup is then a binary search in those counts, plus the scan of (at most) two blocks. The index takes 1/512 of the size of the string.
+      ///
+      /// The parser context has one (bound to the string being parsed), that attributes can request with a `const line_index &` as first parameter:
+      /// \code static node *attr_var(const neam::ct::alphyn::line_index &lines, const token_type &tk) { return new var_node(tk, lines.get_position(tk.start_index)); } \endcode
+      /// \note The lazy build makes the lookups not thread safe (the const member functions modify the index)
+      class line_index
+      {
+        public:
+          /// \brief The size of the blocks (in bytes)
+          static constexpr size_t block_size = 4096;
+
+          line_index() = default;
+
+          /// \param size The size of the string. If unknown (-1), the string must be null-terminated: only what is before the offsets
+          ///             that are looked up will be read
+          explicit line_index(const char *_str, size_t _size = size_t(-1)) : str(_str), size(_size) {}
+
+          /// \brief Index another string (what has been built is forgotten, the memory is kept)
+          void reset(const char *_str, size_t _size = size_t(-1))
+          {
+            str = _str;
+            size = _size;
+            line_counts.clear();
+          }
+
+          /// \brief Return the line and the column of the character at \p offset
+          text_position get_position(size_t offset) const
+          {
+            if (offset > size)
+              offset = size;
+            const size_t block = offset / block_size;
+            _build(block);
+
+            const char *block_start = str + block * block_size;
+            const size_t newlines = line_counts[block] + _count_newlines(block_start, offset - block * block_size);
+
+            // where the line starts: after the last '\n' before offset
+            size_t line_start = 0;
+            const size_t last_in_block = _find_last_newline(block_start, offset - block * block_size);
+            if (last_in_block != size_t(-1))
+              line_start = block * block_size + last_in_block + 1;
+            else if (newlines)
+            {
+              // the last '\n' before the block is in the last block that starts with less newlines before it
+              const size_t nl_block = size_t(std::upper_bound(line_counts.begin(), line_counts.begin() + block + 1, newlines - 1) - line_counts.begin()) - 1;
+              line_start = nl_block * block_size + _find_last_newline(str + nl_block * block_size, block_size) + 1;
+            }
+            return text_position {newlines + 1, offset - line_start + 1};
+          }
+
+          /// \brief Return the line of the character at \p offset (starting at 1)
+          size_t get_line(size_t offset) const
+          {
+            if (offset > size)
+              offset = size;
+            const size_t block = offset / block_size;
+            _build(block);
+            return line_counts[block] + _count_newlines(str + block * block_size, offset - block * block_size) + 1;
+          }
+
+        private:
+          /// \brief Make sure the counts up to block \p block (included) are there. Only the blocks before \p block are read.
+          void _build(size_t block) const
+          {
+            if (line_counts.empty())
+              line_counts.push_back(0);
+            while (line_counts.size() <= block)
+            {
+              const size_t index = line_counts.size() - 1;
+              line_counts.push_back(line_counts.back() + _count_newlines(str + index * block_size, block_size));
+            }
+          }
+
+          /// \brief Return the bitmap of the '\n' of the 64 bytes at \p data
+          static uint64_t _newline_mask(const char *data)
+          {
+#if defined(__AVX2__)
+            const __m256i nl = _mm256_set1_epi8('\n');
+            const uint64_t lo = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)), nl)));
+            const uint64_t hi = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32)), nl)));
+            return lo | (hi << 32);
+#elif defined(__SSE2__)
+            const __m128i nl = _mm_set1_epi8('\n');
+            uint64_t mask = 0;
+            for (size_t i = 0; i < 4; ++i)
+              mask |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 16)), nl)))) << (i * 16);
+            return mask;
+#else
+            uint64_t mask = 0;
+            for (size_t i = 0; i < 64; ++i)
+              mask |= uint64_t(data[i] == '\n') << i;
+            return mask;
+#endif
+          }
+
+          static size_t _popcount(uint64_t v)
+          {
+#if defined(__GNUC__)
+            return size_t(__builtin_popcountll(v));
+#else
+            size_t count = 0;
+            for (; v; v &= v - 1)
+              ++count;
+            return count;
+#endif
+          }
+
+          static size_t _highest_bit(uint64_t v)
+          {
+#if defined(__GNUC__)
+            return 63 - size_t(__builtin_clzll(v));
+#else
+            size_t index = 0;
+            while (v >>= 1)
+              ++index;
+            return index;
+#endif
+          }
+
+          /// \brief Count the '\n' in the \p count first bytes of \p data
+          static size_t _count_newlines(const char *data, size_t count)
+          {
+            size_t ret = 0;
+            size_t i = 0;
+            for (; i + 64 <= count; i += 64)
+              ret += _popcount(_newline_mask(data + i));
+            for (; i < count; ++i) // don't read past count
+              ret += (data[i] == '\n');
+            return ret;
+          }
+
+          /// \brief Return the index of the last '\n' in the \p count first bytes of \p data (-1 if there's none)
+          static size_t _find_last_newline(const char *data, size_t count)
+          {
+            size_t i = count;
+            for (; i % 64 && i > 0; --i) // the end that isn't a whole 64 bytes chunk
+            {
+              if (data[i - 1] == '\n')
+                return i - 1;
+            }
+            for (; i > 0; i -= 64)
+            {
+              const uint64_t mask = _newline_mask(data + i - 64);
+              if (mask)
+                return i - 64 + _highest_bit(mask);
+            }
+            return size_t(-1);
+          }
+
+        private:
+          const char *str = nullptr;
+          size_t size = size_t(-1);
+          mutable std::vector<size_t> line_counts; // the number of '\n' before each block
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_2905113541164729360_2470193873__LINE_INDEX_HPP__*/
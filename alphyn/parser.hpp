@@ -30,11 +30,17 @@
 #ifndef __N_344197126521316_132228520__PARSER_HPP__2___
 # define __N_344197126521316_132228520__PARSER_HPP__2___
 
+#include <vector>
+#include <memory>
+#include <algorithm>
+
 #include "lexer.hpp"
 #include "grammar.hpp"
 #include "grammar_tools.hpp"
 #include "parser_tools.hpp"
 #include "ct_parser.hpp"
+#include "work_stealing.hpp"
+#include "record_splitter.hpp"
 
 namespace neam
 {
@@ -54,6 +60,8 @@ namespace neam
         call_advanced_error_handler,     ///< \brief An (advanced) error handler (located in SyntaxClass::on_parse_error) is called.
                                 /// The on_parse_error must have the following def:
                                 /// \code template<typename ReturnType> ReturnType on_parse_error(const char *str, size_t start_index, uts_t &stack, lexem_list<SyntaxClass> &current_token); \endcode
+        return_result,          ///< \brief parse_string() (and parse_prefix()) return a parse_result<ReturnType> that holds either the value or a parse_error.
+                                /// Nothing is thrown, nothing is allocated, and it also works at compile-time.
       };
 
       namespace internal
@@ -99,17 +107,210 @@ namespace neam
         };
       } // namespace internal
 
+      template<typename Parser, typename ReturnType> class push_parser;
+
+      /// \brief A parser context holds everything a parser needs at runtime (mostly its stack).
+      /// Creating it once and passing it to parse_string() avoids the construction (and the zero-initialization)
+      /// of the stack at each call, which is what dominates the parse time of very small strings.
+      /// The context also owns the arena given to the attributes that request one (see arena.hpp), and it is reset
+      /// with the context: what has been allocated during a parse lives until the next parse (or the destruction of the context).
+      /// It also has the line index of the string being parsed (see line_index.hpp), for the attributes that request it and for the
+      /// diagnostics made after the parse (it's built lazily, so it costs nothing if nobody asks for a line).
+      /// If the parser has the collect_statistics policy, the statistics are recorded in the context, and if it has
+      /// the ring_buffer_trace<> policy, the last events of the parse are recorded in the context.
+      /// \note A context can't be used by two parse_string() at the same time. (use one context per thread)
+      /// \code
+      /// math_eval::parser::context ctx;
+      /// for (const char *str : my_strings)
+      ///   math_eval::parser::parse_string<float>(ctx, str);
+      /// \endcode
+      template<typename Parser>
+      class parser_context
+      {
+        public:
+          using parser_t = Parser;
+          using uts_t = typename Parser::uts_t;
+
+          /// \param arena_block_size The size of the blocks of the arena (only used if the grammar needs an arena)
+          explicit parser_context(size_t arena_block_size = arena::default_block_size)
+            : memory(arena_block_size), trace(Parser::tracer_policy_t::buffer_size)
+          {}
+
+          /// \param allocator The allocator the stack gets its memory from (the parser must have the growable_stack<Allocator> policy)
+          /// \param arena_block_size The size of the blocks of the arena (only used if the grammar needs an arena)
+          explicit parser_context(const typename Parser::stack_policy_t::allocator_type &allocator, size_t arena_block_size = arena::default_block_size)
+            : stack(allocator), memory(arena_block_size), trace(Parser::tracer_policy_t::buffer_size)
+          {}
+
+          /// \brief Reset the context, in O(1) (if there's no destructors to call in the arena). Called by parse_string() before each parse.
+          /// \note The line index is kept as is
+          void reset()
+          {
+            stack.reset();
+            memory.reset();
+            stack.set_arena(&memory);
+            stack.set_line_index(&lines);
+            stack.set_statistics(&statistics);
+            Parser::statistics_policy_t::template on_reset<internal::statistics_layout<typename Parser::syntax_class, Parser>>(&statistics);
+            stack.set_trace(&trace);
+            trace.clear();
+          }
+
+          /// \brief Reset the context and bind the line index to \p str, the string that will be parsed
+          void reset(const char *str)
+          {
+            reset();
+            lines.reset(str);
+          }
+
+          /// \brief Return the arena of the context
+          arena &get_arena()
+          {
+            return memory;
+          }
+
+          /// \brief Return the line index of the string of the last parse
+          const line_index &get_line_index() const
+          {
+            return lines;
+          }
+
+          /// \brief Return what the parser has done, for the last parse and since the creation of the context
+          /// (the parser must have the collect_statistics policy, see statistics_policy.hpp: without it the context holds nothing)
+          /// \see parser::print_statistics()
+          const parser_statistics &get_statistics() const
+          {
+            // If you see this, the parser hasn't the collect_statistics policy (the context holds no statistics)
+            static_assert(Parser::statistics_policy_t::enabled, "get_statistics needs a parser with the collect_statistics policy");
+            return statistics;
+          }
+
+          /// \brief Set the statistics of the context to 0
+          void clear_statistics()
+          {
+            statistics.clear();
+          }
+
+          /// \brief Return the last events of the last parse (the parser must have the ring_buffer_trace<> policy, see tracer_policy.hpp)
+          /// \see parser::print_trace()
+          const trace_buffer &get_trace() const
+          {
+            // If you see this, the parser hasn't the ring_buffer_trace<> policy (the context holds no trace)
+            static_assert(std::is_same<typename Parser::tracer_policy_t::trace_storage, trace_buffer>::value, "get_trace needs a parser with the ring_buffer_trace<> policy");
+            return trace;
+          }
+
+          /// \brief Return the stack, as left by the last parse
+          const uts_t &get_stack() const
+          {
+            return stack;
+          }
+
+        private:
+          uts_t stack;
+          arena memory;
+          line_index lines;
+          typename Parser::statistics_policy_t::statistics_storage statistics; // (empty without statistics)
+          typename Parser::tracer_policy_t::trace_storage trace; // (empty without ring_buffer_trace<>)
+
+          friend Parser;
+          template<typename P, typename R> friend class push_parser;
+      };
+
+      /// \brief An error reported by parser::parse_batch()
+      struct batch_error
+      {
+        size_t index;   ///< \brief The index of the input that failed
+        size_t offset;  ///< \brief The offset (in the input string) of the token that caused the failure
+      };
+
+      /// \brief Why a parse has failed (see on_parse_error::return_result)
+      template<typename TypeT>
+      struct parse_error
+      {
+        size_t offset = 0;             ///< \brief The offset (in the input string) of the token that caused the failure
+        TypeT token_type = TypeT();    ///< \brief The type of that token
+        size_t state = 0;              ///< \brief The index of the state of the automaton that has rejected that token (-1 if unknown)
+        bool stack_overflow = false;   ///< \brief true if the failure is because the stack was full
+      };
+
+      /// \brief Either the result of a parse, or a parse_error (returned by the parsers that use on_parse_error::return_result)
+      template<typename T, typename TypeT>
+      class parse_result
+      {
+        public:
+          constexpr parse_result() = default;
+          constexpr parse_result(T &&_value) : value(std::move(_value)), success(true) {}
+          constexpr parse_result(const parse_error<TypeT> &_error) : error(_error) {}
+
+          /// \brief Return true if the parse has succeeded
+          constexpr bool has_value() const { return success; }
+          constexpr explicit operator bool() const { return success; }
+
+          /// \brief Return the value (default-constructed if the parse has failed)
+          constexpr T &get_value() { return value; }
+          constexpr const T &get_value() const { return value; }
+          constexpr T &operator *() { return value; }
+          constexpr const T &operator *() const { return value; }
+
+          /// \brief Return the value, or \p default_value if the parse has failed
+          constexpr T get_value_or(T default_value) const { return success ? value : default_value; }
+
+          /// \brief Return the error (only meaningful if the parse has failed)
+          constexpr const parse_error<TypeT> &get_error() const { return error; }
+
+        private:
+          T value = T();
+          parse_error<TypeT> error = parse_error<TypeT>();
+          bool success = false;
+      };
+
       /// \brief The Alphyn parser
-      template<typename SyntaxClass, on_parse_error OnErrAct = on_parse_error::throw_exception>
+      /// \param Policies Some optional policies that changes the behavior of the parser.
+      ///                 There's the stack policy (fixed_stack<>, checked_stack<>, growable_stack<>, see stack_policy.hpp),
+      ///                 the default being fixed_stack<> (the stack can hold as many elements as there are states in the automaton),
+      ///                 the unit rule policy (keep_unit_rules, the default, or bypass_unit_rules, see automaton_policy.hpp),
+      ///                 the default reduction policy (default_reductions, the default, or no_default_reductions, see automaton_policy.hpp),
+      ///                 the conflict policy (take_first_action, the default, or stop_on_conflicts, see automaton_policy.hpp),
+      ///                 the automaton policy (canonical_lr1, the default, or lalr1, see automaton_policy.hpp)
+      ///                 the value policy (compute_values, the default, recognize_only, build_syntax_tree or emit_events<Sink>, see value_policy.hpp)
+      ///                 the statistics policy (no_statistics, the default, or collect_statistics, see statistics_policy.hpp)
+      ///                 and the tracer policy (no_trace, the default, stderr_trace or ring_buffer_trace<>, see tracer_policy.hpp).
+      template<typename SyntaxClass, on_parse_error OnErrAct = on_parse_error::throw_exception, typename... Policies>
       class parser
       {
         private:
-          using automaton = typename grammar_tools<SyntaxClass>::lr1_automaton;
+          using automaton_policy_t = typename internal::get_policy<internal::automaton_policy_kind, canonical_lr1, Policies...>::type;
+          using automaton = typename automaton_policy_t::template automaton<grammar_tools<SyntaxClass>>;
 
         public:
+          using syntax_class = SyntaxClass;
           using type_t = typename SyntaxClass::token_type::type_t;
           using automaton_list = typename automaton::as_type_list;
-          using uts_t = internal::tuple_stack<SyntaxClass, automaton_list::size, type_t, typename SyntaxClass::grammar::return_type_list>;
+          static_assert(automaton_list::template get_type_index<automaton>::index == 0, "the initial state must be the first state of the automaton");
+          /// \brief The number of states of the automaton used by the parser
+          static constexpr size_t state_count = automaton_list::size;
+          /// \brief The number of states of the canonical LR(1) automaton (the same as state_count, unless the lalr1 policy has merged some states)
+          static constexpr size_t lr1_state_count = grammar_tools<SyntaxClass>::lr1_automaton::as_type_list::size;
+          using stack_policy_t = typename internal::get_policy<internal::stack_policy_kind, fixed_stack<>, Policies...>::type;
+          using value_policy_t = typename internal::get_policy<internal::value_policy_kind, compute_values, Policies...>::type;
+          using statistics_policy_t = typename internal::get_policy<internal::statistics_policy_kind, no_statistics, Policies...>::type;
+          using tracer_policy_t = typename internal::get_policy<internal::tracer_policy_kind, no_trace, Policies...>::type;
+          // the default capacity of the stack is the number of states of the canonical automaton, even when lalr1 has merged some of them:
+          // an input needs as deep a stack with the merged automaton
+          using uts_t = internal::tuple_stack<SyntaxClass, stack_policy_t, value_policy_t, statistics_policy_t, tracer_policy_t, lr1_state_count, type_t, typename SyntaxClass::grammar::return_type_list>;
+          /// \brief True if the unit rules are bypassed (see bypass_unit_rules)
+          static constexpr bool bypasses_unit_rules = internal::get_policy<internal::unit_rule_policy_kind, keep_unit_rules, Policies...>::type::bypass;
+          /// \brief True if the states with a single rule to reduce do it without checking the next token (see default_reductions)
+          static constexpr bool uses_default_reductions = internal::get_policy<internal::default_reduction_policy_kind, default_reductions, Policies...>::type::enabled;
+          /// \brief True if the parse stops in the states that have more than one thing to do with the next token (see stop_on_conflicts)
+          static constexpr bool stops_on_conflicts = internal::get_policy<internal::conflict_policy_kind, take_first_action, Policies...>::type::stop;
+          using context = parser_context<parser>;
+          /// \brief The user context type (SyntaxClass::context_type, if it exists)
+          using user_context_t = internal::user_context_t<SyntaxClass>;
+          /// \brief What parse_string<ReturnType>() returns: ReturnType, or parse_result<ReturnType> with on_parse_error::return_result
+          template<typename ReturnType>
+          using result_t = typename std::conditional<OnErrAct == on_parse_error::return_result, parse_result<ReturnType, type_t>, ReturnType>::type;
 
         private: // compile-time
           /// \brief This way, you can use this parser to construct complex \b **types** !
@@ -147,22 +348,684 @@ namespace neam
           /// \brief parse the string and return the result value
           /// \see ct_parse_string
           template<typename ReturnType>
-          static constexpr ReturnType parse_string(const char *str, size_t start_index = 0)
+          static constexpr result_t<ReturnType> parse_string(const char *str, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request an arena, and the arena lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_arena, "this grammar needs an arena: please use parse_string(context &, str, index)");
+            // If you see this, your grammar has attributes that request the line index, and the line index lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_line_index, "this grammar needs a line index: please use parse_string(context &, str, index)");
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context: please use parse_string(user_context, str, index)");
+
+            uts_t stack = uts_t();
+            return _parse_string<ReturnType>(stack, str, start_index);
+          }
+
+          /// \brief parse the string and return the result value, giving \p user_context to the attributes that request it
+          /// (attributes that have a [const] SyntaxClass::context_type & as first parameter)
+          template<typename ReturnType>
+          static constexpr result_t<ReturnType> parse_string(user_context_t &user_context, const char *str, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request an arena, and the arena lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_arena, "this grammar needs an arena: please use parse_string(context &, user_context, str, index)");
+            // If you see this, your grammar has attributes that request the line index, and the line index lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_line_index, "this grammar needs a line index: please use parse_string(context &, user_context, str, index)");
+
+            uts_t stack = uts_t();
+            stack.set_user_context(&user_context);
+            return _parse_string<ReturnType>(stack, str, start_index);
+          }
+
+          /// \brief parse the string and return the result value, re-using the stack of the context (no per-call initialization)
+          /// \see parser_context
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string(context &ctx, const char *str, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context: please use parse_string(context &, user_context, str, index)");
+
+            ctx.reset(str);
+            ctx.stack.set_user_context(nullptr);
+            return _parse_string<ReturnType>(ctx.stack, str, start_index);
+          }
+
+          /// \brief parse the string and return the result value, re-using the parser context and giving \p user_context to the attributes that request it
+          /// \see parser_context
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string(context &ctx, user_context_t &user_context, const char *str, size_t start_index = 0)
+          {
+            ctx.reset(str);
+            ctx.stack.set_user_context(&user_context);
+            return _parse_string<ReturnType>(ctx.stack, str, start_index);
+          }
+
+          /// \brief Only check that the string is valid: no attribute is called, no value is computed (not even the values of the tokens, if
+          /// the lexer can avoid it: see syntactic_unit). The parser must have the recognize_only policy:
+          /// \code parser<SyntaxClass, on_parse_error::return_result, recognize_only> \endcode
+          /// \return true if the string is valid (what is returned if it isn't depends on the error action of the parser)
+          static constexpr result_t<bool> recognize(const char *str, size_t start_index = 0)
+          {
+            uts_t stack = uts_t();
+            return _recognize(stack, str, start_index);
+          }
+
+          /// \brief Check that the string is valid, re-using the stack of the context
+          /// \see recognize
+          static result_t<bool> recognize(context &ctx, const char *str, size_t start_index = 0)
+          {
+            ctx.reset(str);
+            return _recognize(ctx.stack, str, start_index);
+          }
+
+          /// \brief Parse the string and build its concrete syntax tree in \p tree (that is cleared first, but its memory is reused).
+          /// The parser must have the build_syntax_tree policy: \code parser<SyntaxClass, on_parse_error::throw_exception, build_syntax_tree> \endcode
+          /// No attribute is called.
+          /// \return true on success (what is returned on failure depends on the error action of the parser)
+          static result_t<bool> build_tree(syntax_tree<SyntaxClass> &tree, const char *str, size_t start_index = 0)
           {
+            // If you see this, the parser hasn't the build_syntax_tree policy
+            static_assert(std::is_same<value_policy_t, build_syntax_tree>::value, "build_tree needs a parser with the build_syntax_tree policy");
+
+            uts_t stack = uts_t();
+            tree.clear();
+            return _parse_with_output(stack, tree, str, start_index);
+          }
+
+          /// \brief Build the concrete syntax tree of the string, re-using the stack of the context
+          /// \see build_tree
+          static result_t<bool> build_tree(context &ctx, syntax_tree<SyntaxClass> &tree, const char *str, size_t start_index = 0)
+          {
+            // If you see this, the parser hasn't the build_syntax_tree policy
+            static_assert(std::is_same<value_policy_t, build_syntax_tree>::value, "build_tree needs a parser with the build_syntax_tree policy");
+
+            ctx.reset(str);
+            tree.clear();
+            return _parse_with_output(ctx.stack, tree, str, start_index);
+          }
+
+          /// \brief Parse the string, giving the shifts and the reductions to \p sink as they happen.
+          /// The parser must have the emit_events<Sink> policy: \code parser<SyntaxClass, on_parse_error::throw_exception, emit_events<my_sink>> \endcode
+          /// No attribute is called.
+          /// \return true on success (what is returned on failure depends on the error action of the parser)
+          template<typename Sink>
+          static result_t<bool> parse_events(Sink &sink, const char *str, size_t start_index = 0)
+          {
+            // If you see this, the parser hasn't the emit_events<Sink> policy
+            static_assert(std::is_same<value_policy_t, emit_events<Sink>>::value, "parse_events needs a parser with the emit_events<Sink> policy");
+
             uts_t stack = uts_t();
+            return _parse_with_output(stack, sink, str, start_index);
+          }
+
+          /// \brief Parse the string, giving the shifts and the reductions to \p sink, re-using the stack of the context
+          /// \see parse_events
+          template<typename Sink>
+          static result_t<bool> parse_events(context &ctx, Sink &sink, const char *str, size_t start_index = 0)
+          {
+            // If you see this, the parser hasn't the emit_events<Sink> policy
+            static_assert(std::is_same<value_policy_t, emit_events<Sink>>::value, "parse_events needs a parser with the emit_events<Sink> policy");
+
+            ctx.reset(str);
+            return _parse_with_output(ctx.stack, sink, str, start_index);
+          }
+
+          /// \brief Parse the string, recovering from syntax errors instead of stopping at the first one (panic mode).
+          /// Your grammar must have rules that use the error token (neam::ct::alphyn::error_token_type), like \code stmt -> error ; \endcode
+          /// When the parse fails, states are popped until one can shift the error token, the error token is shifted (its attribute
+          /// parameter is a token of type error_token_type, located where the error has been found), and the input is discarded until
+          /// a token that can follow it is found (here, until a ';').
+          /// \param[out] errors The syntax errors that have been found (and recovered or not)
+          /// \note If the parse can't be recovered, the error action of the parser is performed
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string_with_recovery(const char *str, std::vector<parse_error<type_t>> &errors, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request an arena, and the arena lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_arena, "this grammar needs an arena: please use parse_string_with_recovery(context &, str, errors, index)");
+            // If you see this, your grammar has attributes that request the line index, and the line index lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_line_index, "this grammar needs a line index: please use parse_string_with_recovery(context &, str, errors, index)");
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context, that parse_string_with_recovery can't give");
+
+            uts_t stack = uts_t();
+            return _parse_with_recovery<ReturnType>(stack, str, errors, start_index);
+          }
+
+          /// \brief Parse the string, recovering from syntax errors, using a context
+          /// \see parse_string_with_recovery
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_string_with_recovery(context &ctx, const char *str, std::vector<parse_error<type_t>> &errors, size_t start_index = 0)
+          {
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context, that parse_string_with_recovery can't give");
+
+            ctx.reset(str);
+            return _parse_with_recovery<ReturnType>(ctx.stack, str, errors, start_index);
+          }
+
+          /// \brief Parse the first "sentence" of the string: the parse stops as soon as the start rule can be reduced, and what follows is ignored.
+          /// Your start rule has to end with something that marks the end of a sentence (like a ';' or a '\n' token) for that to be useful.
+          /// \param[out] end_index Where the parse stopped (just after the last token of the sentence). In case of error, the index of the
+          ///                       token that caused the error
+          /// \see parse_records
+          template<typename ReturnType>
+          static constexpr result_t<ReturnType> parse_prefix(const char *str, size_t start_index, size_t &end_index)
+          {
+            // If you see this, your grammar has attributes that request an arena, and the arena lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_arena, "this grammar needs an arena: please use parse_prefix(context &, str, index, end_index)");
+            // If you see this, your grammar has attributes that request the line index, and the line index lives in a parser context
+            static_assert(!SyntaxClass::grammar::uses_line_index, "this grammar needs a line index: please use parse_prefix(context &, str, index, end_index)");
+            // If you see this, your grammar has attributes that request the user context (SyntaxClass::context_type)
+            static_assert(!SyntaxClass::grammar::uses_user_context, "this grammar needs a user context, that can only be given with a parser context");
+
+            uts_t stack = uts_t();
+            return _parse_prefix<ReturnType>(stack, str, start_index, end_index);
+          }
+
+          /// \brief Parse the first "sentence" of the string, using a context
+          /// \see parse_prefix
+          template<typename ReturnType>
+          static result_t<ReturnType> parse_prefix(context &ctx, const char *str, size_t start_index, size_t &end_index)
+          {
+            ctx.reset(str);
+            return _parse_prefix<ReturnType>(ctx.stack, str, start_index, end_index);
+          }
+
+          /// \brief A range over the sentences (records) of a string, parsed one after the other with parse_prefix (the stack is reused).
+          /// Records are parsed on demand, when the iterator is incremented.
+          /// \note If the error action of the parser doesn't throw, the iteration stops at the first error (see has_failed())
+          /// \note If the grammar uses an arena, what has been allocated for a record is only valid until the next record is parsed
+          template<typename ReturnType>
+          class record_range
+          {
+            public:
+              class iterator
+              {
+                public:
+                  result_t<ReturnType> &operator *() const { return range->current; }
+                  result_t<ReturnType> *operator ->() const { return &range->current; }
+                  iterator &operator ++()
+                  {
+                    range->next();
+                    if (range->ended)
+                      range = nullptr;
+                    return *this;
+                  }
+                  bool operator == (const iterator &o) const { return range == o.range; }
+                  bool operator != (const iterator &o) const { return range != o.range; }
+
+                private:
+                  explicit iterator(record_range *_range) : range(_range) {}
+                  record_range *range;
+                  friend record_range;
+              };
+
+            public:
+              record_range(const char *_str, size_t start_index) : str(_str), index(start_index)
+              {
+                ctx.reset(str);
+              }
+
+              /// \brief Set the user context given to the attributes that request it
+              void set_user_context(user_context_t &user_context)
+              {
+                ctx.stack.set_user_context(&user_context);
+              }
+
+              iterator begin()
+              {
+                if (!started)
+                {
+                  started = true;
+                  next();
+                }
+                return iterator(ended ? nullptr : this);
+              }
+              iterator end() { return iterator(nullptr); }
+
+              /// \brief Return the index in the string where the current record starts
+              size_t get_record_start_index() const { return record_start_index; }
+              /// \brief Return the index in the string where the current record ends
+              size_t get_record_end_index() const { return index; }
+              /// \brief Return true if the iteration has been stopped by an error
+              bool has_failed() const { return failed; }
+
+            private:
+              void next()
+              {
+                // skip what can be skipped, and stop if there's nothing else
+                const lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, index);
+                if (failed || str[ll.get_token().start_index] == '\0')
+                {
+                  ended = true;
+                  return;
+                }
+
+                record_start_index = index;
+                ctx.reset();
+                current = _parse_prefix<ReturnType>(ctx.stack, str, index, index);
+                if (!_has_succeeded(ctx.stack))
+                  failed = true;
+              }
+
+            private:
+              context ctx;
+              const char *str;
+              size_t index;
+              size_t record_start_index = 0;
+              result_t<ReturnType> current = result_t<ReturnType>();
+              bool started = false;
+              bool ended = false;
+              bool failed = false;
+          };
+
+          /// \brief Iterate over the sentences (records) of the string
+          /// \code
+          /// for (float value : math_eval::parser::parse_records<float>("1 + 1; 2 * 3; 4 - 2;"))
+          ///   std::cout << value << '\n';
+          /// \endcode
+          /// \see parse_prefix
+          template<typename ReturnType>
+          static record_range<ReturnType> parse_records(const char *str, size_t start_index = 0)
+          {
+            return record_range<ReturnType>(str, start_index);
+          }
+
+          /// \brief Return the set of terminals that the state \p state_index of the automaton accepts (the tokens that were expected
+          /// when the parse failed in that state, see parse_error::state and uts_t::get_error_state()).
+          /// The table is built at compile-time (only if this function is used).
+          static constexpr token_set<type_t> get_expected_tokens(size_t state_index)
+          {
+            return internal::expected_tokens_table<SyntaxClass, parser>::table[state_index];
+          }
+
+          /// \brief Print statistics recorded with the collect_statistics policy (see parser_context::get_statistics()):
+          /// the totals, the number of reductions of each rule, and the states and the edges that have been visited.
+          /// The rules and the edges are printed with SyntaxClass::get_name_for_token_type()
+          static void print_statistics(std::ostream &os, const parse_statistics &stats)
+          {
+            using layout = internal::statistics_layout<SyntaxClass, parser>;
+            os << "parses: " << stats.parse_count << ", tokens: " << stats.token_count << ", shifts: " << stats.shift_count
+               << ", reductions: " << stats.reduction_count << ", max stack depth: " << stats.max_stack_depth << '\n';
+            os << "lexing time: " << stats.lexing_time << "s, parsing time: " << stats.parsing_time << "s\n";
+            os << "reductions per rule:\n";
+            layout::print_rules(os, stats);
+            os << "visited states:\n";
+            for (size_t i = 0; i < stats.state_visits.size(); ++i)
+            {
+              if (stats.state_visits[i])
+                os << "  " << stats.state_visits[i] << "\tS" << i << '\n';
+            }
+            os << "taken edges:\n";
+            layout::print_edges(os, stats);
+          }
+
+          /// \brief Print the events recorded with the ring_buffer_trace<> policy (see parser_context::get_trace()), the oldest first.
+          /// The tokens and the rules are printed with SyntaxClass::get_name_for_token_type()
+          static void print_trace(std::ostream &os, const trace_buffer &trace)
+          {
+            using layout = internal::statistics_layout<SyntaxClass, parser>;
+            if (trace.get_event_count() > trace.size())
+              os << "(" << trace.get_event_count() - trace.size() << " older events have been lost)\n";
+            for (size_t i = 0; i < trace.size(); ++i)
+            {
+              const trace_event &event = trace[i];
+              switch (event.kind)
+              {
+                case trace_event_kind::enter_state:
+                  os << "S" << event.state << '\n';
+                  break;
+                case trace_event_kind::shift:
+                  os << "  S" << event.state << " <- " << SyntaxClass::get_name_for_token_type(type_t(event.symbol)) << " at " << event.value << '\n';
+                  break;
+                case trace_event_kind::reduce:
+                  os << "  S" << event.state << ": reduce ";
+                  layout::print_rule(os, size_t(event.value));
+                  os << ", back to S" << event.target << '\n';
+                  break;
+                case trace_event_kind::error:
+                  os << "  S" << event.state << ": syntax error on " << SyntaxClass::get_name_for_token_type(type_t(event.symbol)) << " at " << event.value << '\n';
+                  break;
+              }
+            }
+          }
+
+          /// \brief Parse a lot of independent strings using multiple threads.
+          /// Each worker thread has its own context, and the inputs are distributed with work stealing.
+          /// \param inputs A container of strings (std::string or const char *)
+          /// \param outputs Where the results go, in the same order as inputs. It is resized to the size of inputs.
+          ///                Results of inputs that failed are default-constructed.
+          /// \param thread_count The number of threads to use (the calling thread included). 0 means std::thread::hardware_concurrency()
+          /// \return The list of the inputs that failed to parse (sorted by index). The error action of the parser is not performed.
+          /// \note If an attribute throws, the exception is re-thrown (once every thread has stopped)
+          template<typename ReturnType, typename InputContainer>
+          static std::vector<batch_error> parse_batch(const InputContainer &inputs, std::vector<ReturnType> &outputs, size_t thread_count = 0)
+          {
+            // If you see this, your grammar has attributes that request an arena. As the arena of a worker is reset at each parse,
+            // the results would not outlive the parse of the next input.
+            static_assert(!SyntaxClass::grammar::uses_arena, "parse_batch can't be used with grammars that use an arena");
+            // If you see this, your grammar has attributes that request a user context, which parse_batch can't give.
+            static_assert(!SyntaxClass::grammar::uses_user_context, "parse_batch can't be used with grammars that need a user context");
+
+            const size_t count = inputs.size();
+            outputs.clear();
+            outputs.resize(count);
+
+            if (!thread_count)
+              thread_count = std::thread::hardware_concurrency();
+            if (!thread_count)
+              thread_count = 1;
+
+            std::vector<std::unique_ptr<context>> contexts(thread_count);
+            std::vector<std::vector<batch_error>> errors(thread_count);
+
+            internal::parallel_for_each_index(count, thread_count, [&](size_t worker_index, size_t index)
+            {
+              if (!contexts[worker_index])
+                contexts[worker_index].reset(new context);
+              context &ctx = *contexts[worker_index];
+              const char *str = _c_str(*(std::begin(inputs) + index));
+              ctx.reset(str);
+
+              lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, 0);
+              if (_parse(ctx.stack, ll))
+                outputs[index] = std::move(ctx.stack.template get<ReturnType>());
+              else
+                errors[worker_index].push_back(batch_error {index, ll.get_token().start_index});
+            });
+
+            std::vector<batch_error> ret;
+            for (std::vector<batch_error> &it : errors)
+              ret.insert(ret.end(), it.begin(), it.end());
+            std::sort(ret.begin(), ret.end(), [](const batch_error &a, const batch_error &b) { return a.index < b.index; });
+            return ret;
+          }
+
+          /// \brief Parse a lot of independent strings, advancing \p StreamCount of them in lock-step (one token each, in a round-robin fashion)
+          /// on the calling thread. That way the (unpredictable) branches and memory accesses of a stream can overlap with the work on the others.
+          /// The parse is done by the iterative parser (a table of states), so the stack of each stream is explicit.
+          /// \param inputs A container of strings (std::string or const char *)
+          /// \param outputs Where the results go, in the same order as inputs. It is resized to the size of inputs.
+          ///                Results of inputs that failed are default-constructed.
+          /// \return The list of the inputs that failed to parse (sorted by index). The error action of the parser is not performed.
+          /// \see parse_batch
+          template<size_t StreamCount = 4, typename ReturnType, typename InputContainer>
+          static std::vector<batch_error> parse_interleaved(const InputContainer &inputs, std::vector<ReturnType> &outputs)
+          {
+            static_assert(StreamCount > 0, "parse_interleaved needs at least one stream");
+            // If you see this, your grammar has attributes that request an arena. As the arena of a stream is reset at each parse,
+            // the results would not outlive the parse of the next input.
+            static_assert(!SyntaxClass::grammar::uses_arena, "parse_interleaved can't be used with grammars that use an arena");
+            // If you see this, your grammar has attributes that request a user context, which parse_interleaved can't give.
+            static_assert(!SyntaxClass::grammar::uses_user_context, "parse_interleaved can't be used with grammars that need a user context");
+
+            using iterative = internal::iterative_parser<SyntaxClass, parser>;
+            struct stream
+            {
+              context ctx;
+              lexem_list<SyntaxClass> ll = lexem_list<SyntaxClass>("", 0);
+              typename iterative::position pos;
+              size_t index;
+              bool active = false;
+            };
+
+            const size_t count = inputs.size();
+            outputs.clear();
+            outputs.resize(count);
+            std::vector<batch_error> errors;
+
+            std::unique_ptr<stream[]> streams(new stream[StreamCount]);
+            size_t next_input = 0;
+            size_t active_count = 0;
+
+            auto start_stream = [&](stream &st)
+            {
+              st.active = next_input < count;
+              if (!st.active)
+                return;
+              st.index = next_input++;
+              const char *str = _c_str(*(std::begin(inputs) + st.index));
+              st.ctx.reset(str);
+              st.ll = lexer<SyntaxClass>::get_lazy_lexer(str, 0);
+              st.pos = typename iterative::position();
+              ++active_count;
+            };
+
+            for (size_t i = 0; i < StreamCount; ++i)
+              start_stream(streams[i]);
+
+            while (active_count)
+            {
+              for (size_t i = 0; i < StreamCount; ++i)
+              {
+                stream &st = streams[i];
+                if (!st.active || iterative::advance(st.ctx.stack, st.ll, st.pos))
+                  continue;
+
+                // the parse of that stream has ended
+                --active_count;
+                if (_has_succeeded(st.ctx.stack))
+                  outputs[st.index] = std::move(st.ctx.stack.template get<ReturnType>());
+                else
+                  errors.push_back(batch_error {st.index, st.ll.get_token().start_index});
+                start_stream(st);
+              }
+            }
+
+            std::sort(errors.begin(), errors.end(), [](const batch_error &a, const batch_error &b) { return a.index < b.index; });
+            return errors;
+          }
+
+          /// \brief Parse a (big) string made of independent records (statements, lines, ...) using multiple threads.
+          /// The string is split in segments just after a separator (see split_syntax), each segment is parsed with parse_prefix,
+          /// record after record, and the results of the records are combined (in order) with \p reduce.
+          /// \code
+          /// float sum;
+          /// auto errors = math_eval::parser::parse_file_parallel<float, split_syntax<';'>>(str, size, sum, [](float a, float b) { return a + b; });
+          /// \endcode
+          /// \param str The string to parse. It must be followed by a '\0' (str[size] == '\0')
+          /// \param result Where the result goes. It is the combination of the results of all the records (left to right), and is
+          ///               default-constructed if there's no records. It is only meaningful if there's no errors.
+          /// \param reduce A function that combines two results: ReturnType reduce(ReturnType &&left, ReturnType &&right). It must be associative,
+          ///               as the records are first combined by segments, and then the results of the segments are combined.
+          /// \param thread_count The number of threads to use (the calling thread included). 0 means std::thread::hardware_concurrency()
+          /// \return The list of the errors: the parse of a segment stops at its first error. index is the index of the segment, and offset
+          ///         is the offset in str of the token that caused the error. The error action of the parser is not performed.
+          /// \note The start rule of the grammar must end with the separator token (see parse_prefix)
+          template<typename ReturnType, typename SplitSyntax, typename Reduction>
+          static std::vector<batch_error> parse_file_parallel(const char *str, size_t size, ReturnType &result, Reduction &&reduce, size_t thread_count = 0)
+          {
+            // If you see this, your grammar has attributes that request an arena. As the arena of a worker is reset at each record,
+            // the results would not outlive the parse of the next record.
+            static_assert(!SyntaxClass::grammar::uses_arena, "parse_file_parallel can't be used with grammars that use an arena");
+            // If you see this, your grammar has attributes that request a user context, which parse_file_parallel can't give.
+            static_assert(!SyntaxClass::grammar::uses_user_context, "parse_file_parallel can't be used with grammars that need a user context");
+
+            if (!thread_count)
+              thread_count = std::thread::hardware_concurrency();
+            if (!thread_count)
+              thread_count = 1;
+
+            // more segments than threads, so that work stealing can balance the load
+            const std::vector<size_t> bounds = internal::find_split_points<SplitSyntax>(str, size, thread_count > 1 ? thread_count * 8 : 1, thread_count);
+            const size_t segment_count = bounds.size() - 1;
+
+            std::vector<ReturnType> segment_results(segment_count);
+            std::vector<char> segment_has_result(segment_count, 0);
+            std::vector<std::unique_ptr<context>> contexts(thread_count);
+            std::vector<std::vector<batch_error>> errors(thread_count);
+
+            internal::parallel_for_each_index(segment_count, thread_count, [&](size_t worker_index, size_t segment)
+            {
+              if (!contexts[worker_index])
+              {
+                contexts[worker_index].reset(new context);
+                contexts[worker_index]->reset(str);
+              }
+              context &ctx = *contexts[worker_index];
+
+              size_t index = bounds[segment];
+              while (true)
+              {
+                lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, index);
+                const size_t token_start = ll.get_token().start_index;
+                if (token_start >= bounds[segment + 1] || str[token_start] == '\0')
+                  break;
+
+                ctx.reset();
+                ctx.stack.set_prefix_mode(true);
+                if (!_parse(ctx.stack, ll))
+                {
+                  errors[worker_index].push_back(batch_error {segment, ll.get_token().start_index});
+                  break;
+                }
+                index = ll.get_start_index();
+
+                ReturnType &value = ctx.stack.template get<ReturnType>();
+                if (segment_has_result[segment])
+                  segment_results[segment] = reduce(std::move(segment_results[segment]), std::move(value));
+                else
+                  segment_results[segment] = std::move(value);
+                segment_has_result[segment] = 1;
+              }
+            });
+
+            result = ReturnType();
+            bool has_result = false;
+            for (size_t i = 0; i < segment_count; ++i)
+            {
+              if (!segment_has_result[i])
+                continue;
+              result = has_result ? reduce(std::move(result), std::move(segment_results[i])) : std::move(segment_results[i]);
+              has_result = true;
+            }
+
+            std::vector<batch_error> ret;
+            for (std::vector<batch_error> &it : errors)
+              ret.insert(ret.end(), it.begin(), it.end());
+            std::sort(ret.begin(), ret.end(), [](const batch_error &a, const batch_error &b) { return a.index < b.index; });
+            return ret;
+          }
+
+        private:
+          static const char *_c_str(const char *str) { return str; }
+          static const char *_c_str(const std::string &str) { return str.c_str(); }
+
+          /// \brief Parse, without handling errors (ll is left at the token that caused the failure)
+          /// \return true on success (the result is then on the top of the stack)
+          static constexpr bool _parse(uts_t &stack, lexem_list<SyntaxClass> &ll)
+          {
+            statistics_policy_t::on_parse_begin(stack.get_statistics());
+            internal::parser_state<SyntaxClass, automaton, parser>::rec_parse(stack, ll);
+            statistics_policy_t::on_parse_end(stack.get_statistics());
+            return _has_succeeded(stack);
+          }
+
+          /// \brief Return true if the stack is in its final state (successful parse)
+          static constexpr bool _has_succeeded(const uts_t &stack)
+          {
+            return !stack.has_overflowed() && stack.size() == 1 && stack.get_top_type() == SyntaxClass::grammar::start_rule;
+          }
+
+          /// \brief Parse the first sentence of str
+          template<typename ReturnType>
+          static constexpr result_t<ReturnType> _parse_prefix(uts_t &stack, const char *str, size_t start_index, size_t &end_index)
+          {
             lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, start_index);
-            internal::parser_state<SyntaxClass, automaton>::rec_parse(stack, ll);
-            const bool has_failed = !(stack.size() == 1 && stack.get_top_type() == SyntaxClass::grammar::start_rule);
-            return !has_failed ? stack.template get<ReturnType>() :
+            stack.set_prefix_mode(true);
+            const bool has_failed = !_parse(stack, ll);
+            end_index = has_failed ? ll.get_token().start_index : ll.get_start_index();
+            return !has_failed ? result_t<ReturnType>(std::move(stack.template get<ReturnType>())) :
+
+            // The parser is unable to parse the string. (see _parse_string)
+            _on_failure<ReturnType>(str, start_index, stack, ll, std::integral_constant<bool, OnErrAct == on_parse_error::return_result>());
+          }
+
+          /// \brief Parse with the iterative parser, recovering from errors
+          template<typename ReturnType>
+          static result_t<ReturnType> _parse_with_recovery(uts_t &stack, const char *str, std::vector<parse_error<type_t>> &errors, size_t start_index)
+          {
+            using iterative = internal::iterative_parser<SyntaxClass, parser>;
+
+            lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, start_index);
+            typename iterative::position pos;
+            size_t last_error_offset = size_t(-1);
+            statistics_policy_t::on_parse_begin(stack.get_statistics());
+            while (true)
+            {
+              while (iterative::advance(stack, ll, pos));
+              if (_has_succeeded(stack) || stack.has_overflowed())
+                break;
+
+              // an error at the same place as the previous one: the last recovery hasn't consumed anything
+              const size_t offset = ll.get_token().start_index;
+              const bool no_progress = (offset == last_error_offset);
+              if (!no_progress)
+                errors.push_back(parse_error<type_t> {offset, ll.get_token().type, stack.get_error_state(), false});
+              last_error_offset = offset;
+
+              if (!iterative::recover(stack, ll, pos, str, no_progress))
+                break;
+            }
+            statistics_policy_t::on_parse_end(stack.get_statistics());
+
+            if (_has_succeeded(stack))
+              return result_t<ReturnType>(std::move(stack.template get<ReturnType>()));
+            if (stack.has_overflowed())
+              errors.push_back(parse_error<type_t> {ll.get_token().start_index, ll.get_token().type, stack.get_error_state(), true});
+            return _on_failure<ReturnType>(str, start_index, stack, ll, std::integral_constant<bool, OnErrAct == on_parse_error::return_result>());
+          }
+
+          /// \brief Where the parse really happens
+          template<typename ReturnType>
+          static constexpr result_t<ReturnType> _parse_string(uts_t &stack, const char *str, size_t start_index)
+          {
+            lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, start_index);
+            const bool has_failed = !_parse(stack, ll);
+            return !has_failed ? result_t<ReturnType>(std::move(stack.template get<ReturnType>())) :
 
             // The parser is unable to parse the string.
             // If you see a compilation error here, it's because you're trying to use this function at compile-time
             // on an invalid string / with an invalid grammar. When used at runtime, it either print something,
             // call a function, or even throw, depending on the settings in the SyntaxClass
-            on_error<ReturnType>(str, start_index, stack, ll);
+            _on_failure<ReturnType>(str, start_index, stack, ll, std::integral_constant<bool, OnErrAct == on_parse_error::return_result>());
+          }
+
+          /// \brief Parse with the recognize_only policy
+          static constexpr result_t<bool> _recognize(uts_t &stack, const char *str, size_t start_index)
+          {
+            // If you see this, the parser hasn't the recognize_only policy
+            static_assert(std::is_same<value_policy_t, recognize_only>::value, "recognize needs a parser with the recognize_only policy");
+
+            lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, start_index, true);
+            return _parse(stack, ll) ? result_t<bool>(true) :
+                   _on_failure<bool>(str, start_index, stack, ll, std::integral_constant<bool, OnErrAct == on_parse_error::return_result>());
+          }
+
+          /// \brief Parse, giving \p output to the value policy (the tree of build_syntax_tree, the sink of emit_events)
+          template<typename Output>
+          static result_t<bool> _parse_with_output(uts_t &stack, Output &output, const char *str, size_t start_index)
+          {
+            stack.set_output(&output);
+            lexem_list<SyntaxClass> ll = lexer<SyntaxClass>::get_lazy_lexer(str, start_index);
+            if (_parse(stack, ll))
+              return result_t<bool>(true);
+            return _on_failure<bool>(str, start_index, stack, ll, std::integral_constant<bool, OnErrAct == on_parse_error::return_result>());
+          }
+
+          /// \brief on_parse_error::return_result: simply return the error (can be used at compile-time)
+          template<typename ReturnType>
+          static constexpr result_t<ReturnType> _on_failure(const char *, size_t, uts_t &stack, lexem_list<SyntaxClass> &ll, std::true_type)
+          {
+            return result_t<ReturnType>(parse_error<type_t> {ll.get_token().start_index, ll.get_token().type, stack.get_error_state(), stack.has_overflowed()});
+          }
+
+          /// \brief The other error actions
+          template<typename ReturnType>
+          static ReturnType _on_failure(const char *str, size_t start_index, uts_t &stack, lexem_list<SyntaxClass> &ll, std::false_type)
+          {
+            return on_error<ReturnType>(str, start_index, stack, ll);
           }
 
-        private:
           /// \brief Call (or not) an handler
           template<typename ReturnType, on_parse_error OPE> struct _on_error_switcher
           {
@@ -179,7 +1042,8 @@ namespace neam
             if (OnErrAct == on_parse_error::print_message)
               on_error_print_message(str, start_index, stack, ll);
             if (OnErrAct == on_parse_error::print_message || OnErrAct == on_parse_error::throw_exception)
-              throw std::runtime_error(std::string("alphyn::parse_string: could not parse the string") /* + ...*/);
+              throw std::runtime_error(std::string("alphyn::parse_string: could not parse the string")
+                                       + (stack.has_overflowed() ? " (stack overflow)" : ""));
 
             if (OnErrAct == on_parse_error::call_error_handler)
               return _on_error_switcher<ReturnType, OnErrAct>::call_handler(str, start_index, stack, ll);
@@ -209,9 +1073,21 @@ namespace neam
           static void on_error_print_message(const char *str, size_t start_index, uts_t &stack, lexem_list<SyntaxClass> &ll)
           {
             std::cerr << "\n -- -- SYNTAX ERROR -- --" << std::endl;
+            if (stack.has_overflowed())
+              std::cerr << "the parser stack has overflowed (capacity: " << stack.capacity() << ")\n";
             if (stack.size())
               std::cerr << "top type on the stack: " << SyntaxClass::get_name_for_token_type(stack.get_top_type()) << std::endl;
             std::cerr << "current token: " << SyntaxClass::get_name_for_token_type(ll.get_token().type) << '\n';
+            if (stack.get_error_state() != size_t(-1))
+            {
+              const token_set<type_t> expected = get_expected_tokens(stack.get_error_state());
+              std::cerr << "expected: ";
+              for (size_t i = 0; i < expected.size; ++i)
+                std::cerr << (i ? " or " : "") << SyntaxClass::get_name_for_token_type(expected.tokens[i]);
+              if (expected.end_of_input)
+                std::cerr << (expected.size ? " or " : "") << "[end of input]";
+              std::cerr << '\n';
+            }
             try
             {
               auto toptk = ll.get_token();
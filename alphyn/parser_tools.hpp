@@ -31,12 +31,23 @@
 # define __N_173826070108225409_533114535__PARSER_TOOLS_HPP__
 
 #include <utility>
-#include <tools/ct_tuple.hpp>
+#include <type_traits>
+#include <ostream>
+#include <tools/ct_list.hpp>
 #include <tools/genseq.hpp>
 #include <tools/execute_pack.hpp>
 
 #include "grammar_attributes.hpp"
 #include "lexem_list.hpp"
+#include "stack_policy.hpp"
+#include "automaton_policy.hpp"
+#include "value_policy.hpp"
+#include "statistics_policy.hpp"
+#include "tracer_policy.hpp"
+#include "grammar_tools.hpp" // for _default_reduction
+#include "arena.hpp"
+#include "line_index.hpp"
+#include "default_token.hpp"
 
 namespace neam
 {
@@ -44,43 +55,264 @@ namespace neam
   {
     namespace alphyn
     {
+      /// \brief A set of terminals (see parser::get_expected_tokens())
+      template<typename TypeT>
+      struct token_set
+      {
+        const TypeT *tokens;  ///< \brief The terminals
+        size_t size;          ///< \brief The number of terminals
+        bool end_of_input;    ///< \brief true if the end of the input is also accepted
+
+        constexpr const TypeT *begin() const { return tokens; }
+        constexpr const TypeT *end() const { return tokens + size; }
+
+        /// \brief Return true if \p type is in the set
+        constexpr bool contains(TypeT type) const
+        {
+          for (size_t i = 0; i < size; ++i)
+          {
+            if (tokens[i] == type)
+              return true;
+          }
+          return false;
+        }
+      };
+
       namespace internal
       {
+        template<typename T>
+        struct value_slot_leaf
+        {
+          T value = T();
+        };
+
+        /// \brief A slot of the parser stack: it holds a value for each of the types in TypeList
+        /// (like a ct::tuple, but with access by reference, so values can be moved in and out of the slot)
+        template<typename TypeList> class value_slot;
+
+        template<typename... Types>
+        class value_slot<ct::type_list<Types...>> : private value_slot_leaf<Types>...
+        {
+          public:
+            constexpr value_slot() = default;
+
+            template<typename T>
+            constexpr std::decay_t<T> &get()
+            {
+              return static_cast<value_slot_leaf<std::decay_t<T>> &>(*this).value;
+            }
+            template<typename T>
+            constexpr const std::decay_t<T> &get() const
+            {
+              return static_cast<const value_slot_leaf<std::decay_t<T>> &>(*this).value;
+            }
+        };
+
+        /// \brief Retrieve an argument for an attribute from a stack slot.
+        /// Arguments taken by value or by rvalue-reference are moved out of the slot (the slot is about to be popped anyway),
+        /// arguments taken by lvalue-reference are simply referenced.
+        template<typename Arg>
+        struct slot_argument
+        {
+          template<typename Slot>
+          static constexpr std::decay_t<Arg> &&get(Slot &slot)
+          {
+            return std::move(slot.template get<Arg>());
+          }
+        };
+        template<typename Arg>
+        struct slot_argument<Arg &>
+        {
+          template<typename Slot>
+          static constexpr Arg &get(Slot &slot)
+          {
+            return slot.template get<Arg>();
+          }
+        };
+
+        /// \brief Retrieve an injected parameter (a parameter that isn't part of the production rule) for an attribute
+        /// (the default is the user context)
+        template<typename SyntaxClass, typename Param>
+        struct injected_argument
+        {
+          template<typename Stack>
+          static constexpr Param get(Stack &s)
+          {
+            return *s.get_user_context();
+          }
+        };
+        template<typename SyntaxClass>
+        struct injected_argument<SyntaxClass, arena &>
+        {
+          template<typename Stack>
+          static constexpr arena &get(Stack &s)
+          {
+            return *s.get_arena();
+          }
+        };
+        template<typename SyntaxClass>
+        struct injected_argument<SyntaxClass, const line_index &>
+        {
+          template<typename Stack>
+          static constexpr const line_index &get(Stack &s)
+          {
+            return *s.get_line_index();
+          }
+        };
+
+        /// \brief What is stored in the stack for each symbol: the values (compute_values), or what the value policy wants
+        template<typename ValuePolicy, typename SyntaxClass, typename TypeList, bool ComputesValues = ValuePolicy::computes_values>
+        struct stack_slot
+        {
+          using type = value_slot<TypeList>;
+          using output = void;
+        };
+        template<typename ValuePolicy, typename SyntaxClass, typename TypeList>
+        struct stack_slot<ValuePolicy, SyntaxClass, TypeList, false>
+        {
+          using type = typename ValuePolicy::template slot<SyntaxClass, TypeList>;
+          using output = typename ValuePolicy::template output<SyntaxClass>;
+        };
+
         /// \brief Manages lists of tuples
-        /// The stack is stack-allocated, so no dynamic allocation here
-        template<typename SyntaxClass, size_t MaxCount, typename TypeT, typename TypeList>
-        class tuple_stack
+        /// The memory of the stack is handled by the StackPolicy (see stack_policy.hpp).
+        /// With the fixed_stack / checked_stack policies the stack is stack-allocated, so no dynamic allocation here
+        /// What is done with the symbols (calling the attributes, building a tree, ...) is decided by the ValuePolicy (see value_policy.hpp)
+        /// Where the statistics and the trace are recorded is in the stack_statistics and stack_trace bases (empty if the StatisticsPolicy
+        /// and the TracerPolicy don't record anything)
+        template<typename SyntaxClass, typename StackPolicy, typename ValuePolicy, typename StatisticsPolicy, typename TracerPolicy, size_t DefaultCapacity, typename TypeT, typename TypeList>
+        class tuple_stack : public stack_statistics<typename StatisticsPolicy::statistics_storage>, public stack_trace<typename TracerPolicy::trace_storage>
         {
+          private:
+            using slot_t = typename stack_slot<ValuePolicy, SyntaxClass, TypeList>::type;
+            using computes_values = std::integral_constant<bool, ValuePolicy::computes_values>;
+
           public:
+            /// \brief What the value policy produces (void if it computes values: they are in the stack)
+            using output_t = typename stack_slot<ValuePolicy, SyntaxClass, TypeList>::output;
+
             constexpr tuple_stack() = default;
 
+            /// \brief Construct the stack with the allocator instance of the stack policy (only growable_stack has one)
+            explicit tuple_stack(const typename StackPolicy::allocator_type &allocator)
+              : stack(allocator), state_stack(allocator), type_stack(allocator)
+            {
+              // If you see this, the stack policy doesn't allocate anything (use growable_stack<Allocator>)
+              static_assert(!std::is_same<typename StackPolicy::allocator_type, no_allocator>::value, "only the growable_stack policy takes an allocator");
+            }
+
             /// \brief Push a new value to the stack
+            /// \return false if the stack has overflowed (only checked/growable policies may return false)
             template<typename T>
-            constexpr void push(TypeT type, size_t state_index, T val)
+            constexpr bool push(TypeT type, size_t state_index, T &&val)
             {
-              stack[stack_size].template set<T>(val);
+              if (!reserve(stack_size + 1))
+              {
+                overflow = true;
+                return false;
+              }
+              _shift(stack[stack_size], std::forward<T>(val), computes_values());
               type_stack[stack_size] = type;
               state_stack[stack_size] = state_index;
               ++stack_size;
+              return true;
             }
             /// \brief Get the top value
             template<typename T>
-            constexpr T get(size_t index = 0)
+            constexpr std::decay_t<T> &get(size_t index = 0)
             {
+              // If you see this, the parser has a value policy that doesn't compute values (see value_policy.hpp)
+              static_assert(ValuePolicy::computes_values, "this parser doesn't compute values");
               return stack[stack_size - 1 - index].template get<T>();
             }
 
+            /// \brief Set the arena given to the attributes that request it
+            constexpr void set_arena(arena *_memory_arena)
+            {
+              memory_arena = _memory_arena;
+            }
+            constexpr arena *get_arena() const
+            {
+              return memory_arena;
+            }
+
+            /// \brief Set the line index given to the attributes that request it
+            constexpr void set_line_index(const line_index *_lines)
+            {
+              lines = _lines;
+            }
+            constexpr const line_index *get_line_index() const
+            {
+              return lines;
+            }
+
+            /// \brief Set the user context given to the attributes that request it
+            constexpr void set_user_context(user_context_t<SyntaxClass> *_user_context)
+            {
+              user_context = _user_context;
+            }
+            constexpr user_context_t<SyntaxClass> *get_user_context() const
+            {
+              return user_context;
+            }
+
+            /// \brief Set what the value policy fills (the tree of build_syntax_tree, ...)
+            constexpr void set_output(output_t *_output)
+            {
+              output = _output;
+            }
+            constexpr output_t *get_output() const
+            {
+              return output;
+            }
+
           private:
+            template<typename T>
+            constexpr void _shift(slot_t &slot, T &&val, std::true_type /*computes_values*/)
+            {
+              slot.template get<T>() = std::forward<T>(val);
+            }
+            template<typename T>
+            constexpr void _shift(slot_t &slot, T &&val, std::false_type /*computes_values*/)
+            {
+              ValuePolicy::shift(output, slot, val);
+            }
+
+            template<typename Rule>
+            constexpr void _reduce(size_t dest_elem, std::true_type /*computes_values*/)
+            {
+              sub_call_pop_push(Rule::attribute::function, dest_elem);
+            }
+            template<typename Rule>
+            constexpr void _reduce(size_t dest_elem, std::false_type /*computes_values*/)
+            {
+              ValuePolicy::template reduce<Rule>(output, &stack[dest_elem], stack_size - dest_elem);
+            }
+
+            template<typename Arg>
+            constexpr decltype(auto) _get_argument(size_t slot_index, std::false_type /*is_injected*/)
+            {
+              return slot_argument<Arg>::get(stack[slot_index]);
+            }
+            template<typename Arg>
+            constexpr decltype(auto) _get_argument(size_t, std::true_type /*is_injected*/)
+            {
+              return injected_argument<SyntaxClass, Arg>::get(*this);
+            }
+
             template<typename Ret, typename... Args, size_t... Idxs>
             constexpr Ret _fwd_call(Ret (*function)(Args...), size_t initial, cr::seq<Idxs...>)
             {
-              return function(stack[initial + Idxs].template get<Args>()...);
+              // the first parameters may be injected, the others are taken from the stack
+              constexpr size_t injected_count = injected_parameter_count<SyntaxClass, Args...>::value;
+              return function(_get_argument<Args>(initial + Idxs - injected_count, is_injected_parameter<SyntaxClass, Args>())...);
             }
 
             template<typename Ret, typename... Args>
             constexpr void sub_call_pop_push(Ret (*function)(Args...), size_t dest_elem)
             {
-              stack[dest_elem].template set<Ret>(_fwd_call(function, dest_elem, cr::gen_seq<sizeof...(Args)>()));
+              // the result is moved in the destination slot (the previous value of that slot is either moved-from or unused)
+              stack[dest_elem].template get<Ret>() = _fwd_call(function, dest_elem, cr::gen_seq<sizeof...(Args)>());
             }
 
             template<template<e_forward_mode> class Type>
@@ -88,7 +320,7 @@ namespace neam
             {
               using attr = Type<e_forward_mode::direct>;
               if (attr::index > 0)
-                stack[dest_elem] = stack[dest_elem + attr::index];
+                stack[dest_elem] = std::move(stack[dest_elem + attr::index]);
             }
 
             template<template<e_forward_mode> class Type>
@@ -96,31 +328,100 @@ namespace neam
             {
               using attr = Type<e_forward_mode::direct>;
               using result_type = typename SyntaxClass::token_type::value_t;
-              stack[dest_elem].template set<result_type>(stack[dest_elem + attr::index].template get<typename SyntaxClass::token_type>().value);
+              stack[dest_elem].template get<result_type>() = std::move(stack[dest_elem + attr::index].template get<typename SyntaxClass::token_type>().value);
             }
 
           public:
-            /// \brief Call function, pop the number number of argument, and push the return value
+            /// \brief Call the attribute of Rule (a prod_rule_wrapper), pop the number number of argument, and push the return value
             /// \note Before using this, matches_production_rule must have returned true ! (no check are performed)
             /// \return the state to go
-            template<size_t Count, typename Type>
-            constexpr size_t call_pop_push(TypeT type, Type t)
+            template<typename Rule>
+            constexpr size_t call_pop_push()
             {
-              const size_t dest_elem = stack_size - (Count);
+              const size_t dest_elem = stack_size - (Rule::as_type_list::size);
               // it both call and push
-              sub_call_pop_push(t, dest_elem);
-              type_stack[dest_elem] = type;
+              _reduce<Rule>(dest_elem, computes_values());
+              type_stack[dest_elem] = Rule::rule_name;
               stack_size = dest_elem + 1;
 
               return state_stack[dest_elem];
             }
 
+            /// \brief Change the type of the top element. The stack must not be empty !
+            constexpr void set_top_type(TypeT type)
+            {
+              type_stack[stack_size - 1] = type;
+            }
+
+            /// \brief Return the index of the state the top element has been pushed from. The stack must not be empty !
+            constexpr size_t get_top_state() const
+            {
+              return state_stack[stack_size - 1];
+            }
+
+            /// \brief Return the slot of the element \p index, counted from the bottom of the stack (its value is moved out of it by the glr_parser)
+            constexpr slot_t &get_slot(size_t index)
+            {
+              return stack[index];
+            }
+
+            /// \brief Return the index of the state the element \p index (counted from the bottom of the stack) has been pushed from
+            constexpr size_t get_state(size_t index) const
+            {
+              return state_stack[index];
+            }
+
+            /// \brief Pop the top element (without calling anything). The stack must not be empty !
+            constexpr void pop()
+            {
+              --stack_size;
+            }
+
             /// \brief Return the size of the stack
             constexpr size_t size() const
             {
               return stack_size;
             }
 
+            /// \brief Empty the stack, in O(1): the values in the slots are kept (and will be re-used with an assignation)
+            constexpr void reset()
+            {
+              stack_size = 0;
+              overflow = false;
+              prefix_mode = false;
+              error_state = -1;
+            }
+
+            /// \brief Set the index of the state that has rejected the current token (called by the parser when it fails)
+            constexpr void set_error_state(size_t state_index)
+            {
+              error_state = state_index;
+            }
+            /// \brief Return the index of the state that has rejected the token that made the parse fail (-1 if the parse hasn't failed)
+            constexpr size_t get_error_state() const
+            {
+              return error_state;
+            }
+
+            /// \brief In prefix mode, the start rule is reduced as soon as it is on the stack, whatever follows it
+            /// (so the parse stops at the end of the first "sentence" of the input)
+            constexpr void set_prefix_mode(bool _prefix_mode)
+            {
+              prefix_mode = _prefix_mode;
+            }
+
+            /// \brief Return the maximum size of the stack (for growable stacks, the current capacity)
+            constexpr size_t capacity() const
+            {
+              return type_stack.capacity();
+            }
+
+            /// \brief Return true if a push has failed because the stack was full
+            constexpr bool has_overflowed() const
+            {
+              return overflow;
+            }
+
             /// \brief Return the top type. The stack must not be empty !
             constexpr TypeT get_top_type() const
             {
@@ -145,8 +446,8 @@ namespace neam
               NEAM_EXECUTE_PACK(
                 res &= (type_stack[rev_index++] == T::value)
               );
-              if (!FollowSet::size && res)
-                return lookahead.is_last();
+              if (!FollowSet::size && res) // only the start rule has an empty follow set
+                return prefix_mode || lookahead.is_last();
               if (res)
                 return follow_set<FollowSet>::matches(lookahead.get_token().type);
               return false;
@@ -184,18 +485,93 @@ namespace neam
             };
 
           private:
-            ct::tuple<TypeList> stack[MaxCount] = {};
-            size_t state_stack[MaxCount] = {0};
-            TypeT type_stack[MaxCount] = {0};
+            constexpr bool reserve(size_t count)
+            {
+              return stack.reserve(count) && state_stack.reserve(count) && type_stack.reserve(count);
+            }
+
+          private:
+            template<typename T>
+            using storage = typename StackPolicy::template storage<T, DefaultCapacity>;
+
+            // (the values of empty slots, like those of recognize_only, are not stored at all)
+            typename std::conditional<std::is_empty<slot_t>::value, empty_storage<slot_t>, storage<slot_t>>::type stack = {};
+            storage<size_t> state_stack = {};
+            storage<TypeT> type_stack = {};
             size_t stack_size = 0;
+            bool overflow = false;
+            bool prefix_mode = false;
+            size_t error_state = -1;
+            arena *memory_arena = nullptr;
+            const line_index *lines = nullptr;
+            user_context_t<SyntaxClass> *user_context = nullptr;
+            output_t *output = nullptr;
+        };
+
+        /// \brief How the rules, the states and the edges of a parser are numbered in its parse_statistics and its trace_buffer (defined after the states)
+        template<typename SyntaxClass, typename Parser> struct statistics_layout;
+
+        /// \brief Where the goto on the edge Edge of State leads (see bypass_unit_rules).
+        /// If Bypass is true and the state of the edge can only reduce a unit rule A -> B (with forward_first_attribute),
+        /// the goto on A is directly done instead (and so on).
+        template<typename SyntaxClass, typename State, typename Edge, bool Bypass>
+        struct goto_target
+        {
+          using state = typename Edge::state;
+          static constexpr typename SyntaxClass::token_type::type_t name = Edge::name;
+        };
+
+        template<typename SyntaxClass, typename State, typename Edge>
+        struct goto_target<SyntaxClass, State, Edge, true>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+
+          template<typename S, bool OnlyOneRule = (S::edges::size == 0 && S::final_rules::size == 1)>
+          struct unit_rule
+          {
+            static constexpr bool value = false;
+            static constexpr type_t name = Edge::name;
+          };
+          template<typename S>
+          struct unit_rule<S, true>
+          {
+            using rule = typename S::final_rules::front;
+            static constexpr bool value = rule::as_type_list::size == 1 && std::is_same<typename rule::attribute, forward_first_attribute>::value;
+            static constexpr type_t name = rule::rule_name;
+          };
+
+          template<type_t Name, typename List>
+          struct find_edge
+          {
+            using type = typename std::conditional<List::front::name == Name, typename List::front, typename find_edge<Name, typename List::pop_front>::type>::type;
+          };
+          template<type_t Name>
+          struct find_edge<Name, ct::type_list<>> { using type = void; };
+
+          template<bool IsUnit, bool = false>
+          struct next
+          {
+            using state = typename Edge::state;
+            static constexpr type_t name = Edge::name;
+          };
+          template<bool X>
+          struct next<true, X> : public goto_target<SyntaxClass, State, typename find_edge<unit_rule<typename Edge::state>::name, typename State::edges>::type, true> {};
+
+          using state = typename next<unit_rule<typename Edge::state>::value>::state;
+          static constexpr type_t name = next<unit_rule<typename Edge::state>::value>::name;
         };
 
         /// \brief What actually "parses". It wraps the _state struct adding it the ability to consume a "stream" of token.
-        template<typename SyntaxClass, typename State>
+        /// \note Parser is the alphyn::parser<> that uses this state (it provides the stack type and the list of states)
+        template<typename SyntaxClass, typename State, typename Parser>
         struct parser_state
         {
-          using uts_t = typename SyntaxClass::parser::uts_t;
+          using uts_t = typename Parser::uts_t;
           using type_t = typename SyntaxClass::token_type::type_t;
+          using statistics = typename Parser::statistics_policy_t;
+          using tracer = typename Parser::tracer_policy_t;
+
+          static constexpr size_t state_index = Parser::automaton_list::template get_type_index<State>::index;
 
           /// \brief Extract ct::type_list<...> tpl argument pack
           template<typename List, bool = false>
@@ -205,7 +581,12 @@ namespace neam
             {
               using rule = typename List::front;
               if (uts_t::template production_rule_matcher<typename rule::as_type_list>::template test<typename rule::follow_set>(s, lookahead))
-                return s.template call_pop_push<rule::as_type_list::size>(rule::rule_name, rule::attribute::function);
+              {
+                statistics::template on_reduce<rule>(s.get_statistics());
+                const size_t ret = s.template call_pop_push<rule>();
+                tracer::template on_reduce<rule>(s.get_trace(), state_index, ret);
+                return ret;
+              }
               return production_rule_matcher<typename List::pop_front, false>::test(s, lookahead);
             }
           };
@@ -219,6 +600,30 @@ namespace neam
             }
           };
 
+          /// \brief Reduce one of the final rules of the state (if possible)
+          template<bool HasDefaultReduction, bool = false>
+          struct reducer
+          {
+            constexpr static size_t reduce(uts_t &s, const lexem_list<SyntaxClass> &lookahead)
+            {
+              return production_rule_matcher<typename State::final_rules>::test(s, lookahead);
+            }
+          };
+          template<bool X>
+          struct reducer<true, X>
+          {
+            // default reduction: there's no need to check the stack nor the next token
+            constexpr static size_t reduce(uts_t &s, const lexem_list<SyntaxClass> &)
+            {
+              using rule = typename _default_reduction<SyntaxClass, State>::rule;
+              statistics::template on_reduce<rule>(s.get_statistics());
+              const size_t ret = s.template call_pop_push<rule>();
+              tracer::template on_reduce<rule>(s.get_trace(), state_index, ret);
+              return ret;
+            }
+          };
+          using state_reducer = reducer<Parser::uses_default_reductions && _default_reduction<SyntaxClass, State>::value>;
+
           /// \brief Handle edges
           template<typename List, bool IsPost>
           struct on_edge
@@ -228,15 +633,24 @@ namespace neam
               using current_edge = typename List::front;
               if (current_edge::name == type)
               {
+                statistics::template on_edge<statistics_layout<SyntaxClass, Parser>>(s.get_statistics(), state_index, State::edges::size - List::size);
                 if (!IsPost)
                 {
                   const type_t type = ll.get_token().type;
-                  constexpr size_t state_index = SyntaxClass::parser::automaton_list::template get_type_index<State>::index;
-                  s.push(type, state_index, ll.get_token()); // in case of error, the last token is what caused the failure.
-                  // std::cout << " <- " << SyntaxClass::get_name_for_token_type(type) << " [" << ll.get_token().value << "] " << '\n'; // DEBUG
-                  ll = ll.get_next();
+                  if (!s.push(type, state_index, ll.get_token())) // in case of error, the last token is what caused the failure.
+                  {
+                    s.set_error_state(state_index);
+                    tracer::template on_error<SyntaxClass>(s.get_trace(), state_index, ll.get_token());
+                    return -1; // the stack is full
+                  }
+                  statistics::on_shift(s.get_statistics(), s.size());
+                  tracer::template on_shift<SyntaxClass>(s.get_trace(), state_index, ll.get_token());
+                  statistics::next_token(s.get_statistics(), ll);
                 }
-                return parser_state<SyntaxClass, typename current_edge::state>::rec_parse(s, ll);
+                using target = goto_target<SyntaxClass, State, current_edge, IsPost && Parser::bypasses_unit_rules>;
+                if (target::name != current_edge::name)
+                  s.set_top_type(target::name); // unit rules have been bypassed
+                return parser_state<SyntaxClass, typename target::state, Parser>::rec_parse(s, ll);
               }
               return on_edge<typename List::pop_front, IsPost>::forward(s, ll, type);
             }
@@ -244,40 +658,596 @@ namespace neam
           template<bool IsPost>
           struct on_edge<ct::type_list<>, IsPost>
           {
-            constexpr static size_t forward(uts_t &, lexem_list<SyntaxClass> &, type_t)
+            constexpr static size_t forward(uts_t &s, lexem_list<SyntaxClass> &ll, type_t)
             {
+              // no edge for the current token: this is where the parse fails
+              if (!IsPost)
+              {
+                s.set_error_state(state_index);
+                tracer::template on_error<SyntaxClass>(s.get_trace(), state_index, ll.get_token());
+              }
               return -1;
             };
           };
 
+          /// \brief With the stop_on_conflicts policy, fail (like on a syntax error) if the state has more than one thing to do with the next token
+          template<bool StopsOnConflicts, bool = false>
+          struct conflict_checker
+          {
+            constexpr static bool stop(uts_t &, const lexem_list<SyntaxClass> &)
+            {
+              return false;
+            }
+          };
+          template<bool X>
+          struct conflict_checker<true, X>
+          {
+            using conflict = _conflict_tokens<SyntaxClass, State>;
+
+            template<typename Tokens> struct token_matcher {};
+            template<typename... Tokens>
+            struct token_matcher<ct::type_list<Tokens...>>
+            {
+              constexpr static bool matches(type_t type)
+              {
+                (void)type; // (when there's no tokens)
+                return any_of((Tokens::value == type)...);
+              }
+            };
+
+            constexpr static bool stop(uts_t &s, const lexem_list<SyntaxClass> &ll)
+            {
+              if (!token_matcher<typename conflict::list>::matches(ll.get_token().type) && !(conflict::at_end && ll.is_last()))
+                return false;
+              s.set_error_state(state_index);
+              tracer::template on_error<SyntaxClass>(s.get_trace(), state_index, ll.get_token());
+              return true;
+            }
+          };
+          using state_conflict_checker = conflict_checker<Parser::stops_on_conflicts>;
+
           /// \brief The state entry point
           static constexpr size_t rec_parse(uts_t &stack, lexem_list<SyntaxClass> &ll)
           {
-            constexpr size_t state_index = SyntaxClass::parser::automaton_list::template get_type_index<State>::index;
-
-            // std::cout << "S" << state_index <<  " [" << State::final_rules::size; // DEBUG
+            statistics::on_enter_state(stack.get_statistics(), state_index);
+            tracer::on_enter_state(stack.get_trace(), state_index);
+            if (state_conflict_checker::stop(stack, ll))
+              return -1;
 
             if (State::final_rules::size)
             {
-              const size_t ret = production_rule_matcher<typename State::final_rules>::test(stack, ll);
-              // std::cout << ", S" << long(ret) << "]x\n"; // DEBUG
+              const size_t ret = state_reducer::reduce(stack, ll);
               if (ret != size_t(-1))
                 return ret;
             }
-            // else std::cout << "]\n"; // DEBUG
 
             size_t forward_ret = on_edge<typename State::edges, false>::forward(stack, ll, ll.get_token().type);
             while (forward_ret == state_index)
             {
+              // the start rule has been reduced: the parse is done (what follows, if anything, is not part of it)
+              if (state_index == 0 && stack.size() == 1 && stack.get_top_type() == SyntaxClass::grammar::start_rule)
+                return -1;
+
               forward_ret = on_edge<typename State::edges, true>::forward(stack, ll, stack.get_top_type());
-              if (forward_ret == size_t(-1))
+              if (forward_ret == size_t(-1) && stack.get_error_state() == size_t(-1)) // no goto (and not a failure in the next states)
                 forward_ret = on_edge<typename State::edges, false>::forward(stack, ll, ll.get_token().type);
             }
 
-            // std::cout << "S" << state_index << "x->S" << long(forward_ret) << "\n"; // DEBUG
             return forward_ret;
           }
         };
+
+        /// \brief The iterative version of parser_state: instead of recursing into the next state, the functions return its index.
+        /// (used by the iterative parser, for the cases where the parse has to be interrupted)
+        template<typename SyntaxClass, typename State, typename Parser>
+        struct parser_state_step
+        {
+          using uts_t = typename Parser::uts_t;
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using statistics = typename Parser::statistics_policy_t;
+          using tracer = typename Parser::tracer_policy_t;
+
+          static constexpr size_t state_index = Parser::automaton_list::template get_type_index<State>::index;
+
+          /// \brief Find the edge named \p type (if \p s isn't null, the edge is recorded as taken)
+          template<typename List, bool = false>
+          struct edge_finder
+          {
+            static size_t find(type_t type, uts_t *s)
+            {
+              using current_edge = typename List::front;
+              if (current_edge::name == type)
+              {
+                if (s)
+                  statistics::template on_edge<statistics_layout<SyntaxClass, Parser>>(s->get_statistics(), state_index, State::edges::size - List::size);
+                return Parser::automaton_list::template get_type_index<typename current_edge::state>::index;
+              }
+              return edge_finder<typename List::pop_front>::find(type, s);
+            }
+          };
+          template<bool X>
+          struct edge_finder<ct::type_list<>, X>
+          {
+            static size_t find(type_t, uts_t *)
+            {
+              return -1;
+            }
+          };
+
+          /// \brief Find the edge named \p type for a goto (unit rules may be bypassed)
+          template<typename List, bool = false>
+          struct goto_finder
+          {
+            static size_t find(uts_t &s, type_t type)
+            {
+              using current_edge = typename List::front;
+              if (current_edge::name == type)
+              {
+                statistics::template on_edge<statistics_layout<SyntaxClass, Parser>>(s.get_statistics(), state_index, State::edges::size - List::size);
+                using target = goto_target<SyntaxClass, State, current_edge, Parser::bypasses_unit_rules>;
+                if (target::name != current_edge::name)
+                  s.set_top_type(target::name);
+                return Parser::automaton_list::template get_type_index<typename target::state>::index;
+              }
+              return goto_finder<typename List::pop_front>::find(s, type);
+            }
+          };
+          template<bool X>
+          struct goto_finder<ct::type_list<>, X>
+          {
+            static size_t find(uts_t &, type_t)
+            {
+              return -1;
+            }
+          };
+
+          /// \brief Return true if the parse has to stop there (see stop_on_conflicts)
+          static bool stop_on_conflict(uts_t &s, const lexem_list<SyntaxClass> &ll)
+          {
+            return parser_state<SyntaxClass, State, Parser>::state_conflict_checker::stop(s, ll);
+          }
+
+          /// \brief Try to reduce the stack with one of the final rules
+          /// \return the index of the state to go back to, -1 if no rule has been reduced
+          static size_t reduce(uts_t &s, const lexem_list<SyntaxClass> &ll)
+          {
+            if (State::final_rules::size)
+              return parser_state<SyntaxClass, State, Parser>::state_reducer::reduce(s, ll);
+            return -1;
+          }
+
+          /// \brief Shift the current token
+          /// \return the index of the next state, -1 if there's no edge for the token (or if the stack is full)
+          static size_t shift(uts_t &s, lexem_list<SyntaxClass> &ll)
+          {
+            const type_t type = ll.get_token().type;
+            const size_t next_state = edge_finder<typename State::edges>::find(type, &s);
+            if (next_state == size_t(-1))
+              return -1;
+            if (!s.push(type, state_index, ll.get_token()))
+              return -1; // the stack is full
+            statistics::on_shift(s.get_statistics(), s.size());
+            tracer::template on_shift<SyntaxClass>(s.get_trace(), state_index, ll.get_token());
+            statistics::next_token(s.get_statistics(), ll);
+            return next_state;
+          }
+
+          /// \brief Return the state to go after a reduction (to the non-terminal on the top of the stack), -1 if there's none
+          static size_t go_to(uts_t &s)
+          {
+            return goto_finder<typename State::edges>::find(s, s.get_top_type());
+          }
+
+          /// \brief Return the state the edge named \p type leads to, -1 if there's none
+          static size_t find_edge(type_t type)
+          {
+            return edge_finder<typename State::edges>::find(type, nullptr);
+          }
+        };
+
+        // get the ct::type_list<> the automaton list derives from
+        template<typename... States>
+        ct::type_list<States...> as_plain_type_list(const ct::type_list<States...> *);
+
+        /// \brief Tell if a type is a non-terminal of the grammar
+        template<typename NonTerminalList> struct non_terminal_checker {};
+        template<typename... NonTerminals>
+        struct non_terminal_checker<ct::type_list<NonTerminals...>>
+        {
+          template<typename TypeT>
+          static constexpr bool is_non_terminal(TypeT type)
+          {
+            return any_of((NonTerminals::value == type)...);
+          }
+        };
+
+        /// \brief A set of terminals, stored in a fixed-size array (built at compile-time)
+        template<typename TypeT, size_t Capacity>
+        struct token_set_storage
+        {
+          TypeT tokens[Capacity ? Capacity : 1] = {};
+          size_t size = 0;
+          bool end_of_input = false;
+
+          constexpr void insert(TypeT type)
+          {
+            for (size_t i = 0; i < size; ++i)
+            {
+              if (tokens[i] == type)
+                return;
+            }
+            tokens[size++] = type;
+          }
+        };
+
+        /// \brief The terminals that a state accepts: the names of its edges (minus the non-terminals, that are gotos)
+        /// and the follow sets of its final rules: what the state doesn't reject right away. With the canonical LR(1) automaton, that's exactly
+        /// what is valid there. With lalr1, the follow sets of the merged states are unions, so it can have tokens that are reduced and then
+        /// rejected a few states later. And a state with a default reduction doesn't check the token: the error is found (and reported)
+        /// in a state reached after the reduction.
+        template<typename SyntaxClass, typename State>
+        struct state_expected_tokens
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using non_terminals = non_terminal_checker<typename SyntaxClass::grammar::non_terminal_list>;
+
+          template<typename Rule> using get_follow_set = typename Rule::follow_set;
+          template<typename Rule> using has_empty_follow_set = std::integral_constant<bool, Rule::follow_set::size == 0>;
+
+          template<typename Edges, typename Follows, typename FinalRules> struct builder {};
+          template<typename... Edges, typename... Follows, typename... FinalRules>
+          struct builder<ct::type_list<Edges...>, ct::type_list<Follows...>, ct::type_list<FinalRules...>>
+          {
+            using storage = token_set_storage<type_t, sizeof...(Edges) + sizeof...(Follows)>;
+
+            static constexpr storage make()
+            {
+              storage ret;
+              // the error token is never given by the lexer, so it's never expected (an edge on it is used by the error recovery)
+              const type_t error_type = static_cast<type_t>(error_token_type);
+              const type_t edge_names[] = {type_t(), Edges::name...};
+              for (size_t i = 1; i < sizeof...(Edges) + 1; ++i)
+              {
+                if (!non_terminals::is_non_terminal(edge_names[i]) && edge_names[i] != error_type)
+                  ret.insert(edge_names[i]);
+              }
+              const type_t follows[] = {type_t(), Follows::value...};
+              for (size_t i = 1; i < sizeof...(Follows) + 1; ++i)
+              {
+                if (follows[i] != error_type)
+                  ret.insert(follows[i]);
+              }
+              // only the start rule has an empty follow set: it is reduced at the end of the input
+              ret.end_of_input = any_of(has_empty_follow_set<FinalRules>::value...);
+              return ret;
+            }
+          };
+
+          using final_rules = typename State::final_rules;
+          using current_builder = builder<typename State::edges, typename final_rules::template direct_for_each<get_follow_set>::flatten::make_unique, final_rules>;
+
+          static constexpr typename current_builder::storage value = current_builder::make();
+        };
+        template<typename SyntaxClass, typename State>
+        constexpr typename state_expected_tokens<SyntaxClass, State>::current_builder::storage state_expected_tokens<SyntaxClass, State>::value;
+
+        /// \brief The table of the expected tokens of each state of the automaton (in the order of the automaton list)
+        template<typename SyntaxClass, typename Parser, typename StateList = decltype(as_plain_type_list(static_cast<typename Parser::automaton_list *>(nullptr)))>
+        struct expected_tokens_table {};
+
+        template<typename SyntaxClass, typename Parser, typename... States>
+        struct expected_tokens_table<SyntaxClass, Parser, ct::type_list<States...>>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+
+          static constexpr token_set<type_t> table[sizeof...(States)] =
+          {
+            token_set<type_t>
+            {
+              state_expected_tokens<SyntaxClass, States>::value.tokens,
+              state_expected_tokens<SyntaxClass, States>::value.size,
+              state_expected_tokens<SyntaxClass, States>::value.end_of_input
+            }...
+          };
+        };
+        template<typename SyntaxClass, typename Parser, typename... States>
+        constexpr token_set<typename SyntaxClass::token_type::type_t> expected_tokens_table<SyntaxClass, Parser, ct::type_list<States...>>::table[sizeof...(States)];
+
+        /// \brief The offset of the first edge of each state in parse_statistics::edge_visits (the last one is the number of edges)
+        template<size_t StateCount>
+        struct edge_offset_storage
+        {
+          size_t data[StateCount + 1] = {};
+        };
+
+        template<typename... States>
+        constexpr edge_offset_storage<sizeof...(States)> make_edge_offsets()
+        {
+          const size_t edge_counts[] = {size_t(0), States::edges::size...};
+          edge_offset_storage<sizeof...(States)> ret;
+          for (size_t i = 0; i < sizeof...(States); ++i)
+            ret.data[i + 1] = ret.data[i] + edge_counts[i + 1];
+          return ret;
+        }
+
+        template<typename... RuleSets>
+        constexpr size_t count_rules(const ct::type_list<RuleSets...> *)
+        {
+          const size_t rule_counts[] = {size_t(0), RuleSets::as_type_list::size...};
+          size_t ret = 0;
+          for (size_t count : rule_counts)
+            ret += count;
+          return ret;
+        }
+
+        template<typename SyntaxClass, typename Parser, typename StateList = decltype(as_plain_type_list(static_cast<typename Parser::automaton_list *>(nullptr)))>
+        struct statistics_layout_impl {};
+
+        template<typename SyntaxClass, typename Parser, typename... States>
+        struct statistics_layout_impl<SyntaxClass, Parser, ct::type_list<States...>>
+        {
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using rule_sets = typename SyntaxClass::grammar::as_type_list;
+
+          static constexpr size_t state_count = sizeof...(States);
+          static constexpr edge_offset_storage<sizeof...(States)> edge_offsets = make_edge_offsets<States...>();
+          static constexpr size_t edge_count = edge_offsets.data[sizeof...(States)];
+          static constexpr size_t rule_count = count_rules(static_cast<const rule_sets *>(nullptr));
+
+          /// \brief Print the number of reductions of each rule (rule_count lines)
+          static void print_rules(std::ostream &os, const parse_statistics &stats)
+          {
+            rule_set_printer<rule_sets>::print(os, stats, 0);
+          }
+
+          /// \brief Print the production rule \p rule_id (name -> symbols...)
+          static void print_rule(std::ostream &os, size_t rule_id)
+          {
+            rule_set_printer<rule_sets>::print_rule(os, rule_id);
+          }
+
+          /// \brief Print the edges that have been taken
+          static void print_edges(std::ostream &os, const parse_statistics &stats)
+          {
+            using printer = void (*)(std::ostream &, const parse_statistics &, size_t);
+            static const printer printers[sizeof...(States)] = {&print_state_edges<States>...};
+            for (size_t i = 0; i < sizeof...(States); ++i)
+              printers[i](os, stats, i);
+          }
+
+        private:
+          static size_t _get(const std::vector<size_t> &counts, size_t index)
+          {
+            return index < counts.size() ? counts[index] : 0;
+          }
+
+          template<typename Rules, bool = false>
+          struct rule_printer
+          {
+            static void print(std::ostream &os, const parse_statistics &stats, type_t name, size_t rule_id)
+            {
+              os << "  " << _get(stats.reductions, rule_id) << "\t";
+              print_production<SyntaxClass>(os, name, static_cast<const typename Rules::front::as_type_list *>(nullptr));
+              os << '\n';
+              rule_printer<typename Rules::pop_front>::print(os, stats, name, rule_id + 1);
+            }
+            static void print_rule(std::ostream &os, type_t name, size_t index)
+            {
+              if (!index)
+                print_production<SyntaxClass>(os, name, static_cast<const typename Rules::front::as_type_list *>(nullptr));
+              else
+                rule_printer<typename Rules::pop_front>::print_rule(os, name, index - 1);
+            }
+          };
+          template<bool X>
+          struct rule_printer<ct::type_list<>, X>
+          {
+            static void print(std::ostream &, const parse_statistics &, type_t, size_t) {}
+            static void print_rule(std::ostream &, type_t, size_t) {}
+          };
+
+          template<typename RuleSets, bool = false>
+          struct rule_set_printer
+          {
+            static void print(std::ostream &os, const parse_statistics &stats, size_t rule_id)
+            {
+              using rule_set = typename RuleSets::front;
+              rule_printer<typename rule_set::as_type_list>::print(os, stats, rule_set::rule_name, rule_id);
+              rule_set_printer<typename RuleSets::pop_front>::print(os, stats, rule_id + rule_set::as_type_list::size);
+            }
+            static void print_rule(std::ostream &os, size_t rule_id)
+            {
+              using rule_set = typename RuleSets::front;
+              if (rule_id < rule_set::as_type_list::size)
+                rule_printer<typename rule_set::as_type_list>::print_rule(os, rule_set::rule_name, rule_id);
+              else
+                rule_set_printer<typename RuleSets::pop_front>::print_rule(os, rule_id - rule_set::as_type_list::size);
+            }
+          };
+          template<bool X>
+          struct rule_set_printer<ct::type_list<>, X>
+          {
+            static void print(std::ostream &, const parse_statistics &, size_t) {}
+            static void print_rule(std::ostream &os, size_t rule_id)
+            {
+              os << "rule #" << rule_id;
+            }
+          };
+
+          template<typename Edges, bool = false>
+          struct edge_printer
+          {
+            static void print(std::ostream &os, const parse_statistics &stats, size_t state_index, size_t edge_index)
+            {
+              using edge = typename Edges::front;
+              if (const size_t count = _get(stats.edge_visits, edge_index))
+              {
+                os << "  " << count << "\tS" << state_index << " -- " << SyntaxClass::get_name_for_token_type(edge::name)
+                   << " --> S" << Parser::automaton_list::template get_type_index<typename edge::state>::index << '\n';
+              }
+              edge_printer<typename Edges::pop_front>::print(os, stats, state_index, edge_index + 1);
+            }
+          };
+          template<bool X>
+          struct edge_printer<ct::type_list<>, X>
+          {
+            static void print(std::ostream &, const parse_statistics &, size_t, size_t) {}
+          };
+
+          template<typename State>
+          static void print_state_edges(std::ostream &os, const parse_statistics &stats, size_t state_index)
+          {
+            edge_printer<typename State::edges>::print(os, stats, state_index, edge_offsets.data[state_index]);
+          }
+        };
+        template<typename SyntaxClass, typename Parser, typename... States>
+        constexpr edge_offset_storage<sizeof...(States)> statistics_layout_impl<SyntaxClass, Parser, ct::type_list<States...>>::edge_offsets;
+
+        template<typename SyntaxClass, typename Parser>
+        struct statistics_layout : public statistics_layout_impl<SyntaxClass, Parser> {};
+
+        /// \brief An iterative (and interruptible) parser: the states are in a table of functions and the state to return to after a reduction
+        /// is the one stored in the stack. It has the exact same behavior as the recursive parser_state.
+        template<typename SyntaxClass, typename Parser, typename StateList = decltype(as_plain_type_list(static_cast<typename Parser::automaton_list *>(nullptr)))>
+        class iterative_parser {};
+
+        template<typename SyntaxClass, typename Parser, typename... States>
+        class iterative_parser<SyntaxClass, Parser, ct::type_list<States...>>
+        {
+          public:
+            using uts_t = typename Parser::uts_t;
+            using type_t = typename SyntaxClass::token_type::type_t;
+
+            /// \brief Where a parse is
+            struct position
+            {
+              size_t state = 0;           ///< \brief The current state
+              bool after_reduce = false;  ///< \brief True if the last thing done was a reduction (the goto hasn't been done yet)
+            };
+
+            /// \brief Advance the parse until a token is consumed (or until the parse ends)
+            /// \return false if the parse has ended (either because of an error or because the input has been fully reduced)
+            static bool advance(uts_t &s, lexem_list<SyntaxClass> &ll, position &pos)
+            {
+              while (true)
+              {
+                size_t next_state;
+                if (!pos.after_reduce)
+                {
+                  Parser::statistics_policy_t::on_enter_state(s.get_statistics(), pos.state);
+                  Parser::tracer_policy_t::on_enter_state(s.get_trace(), pos.state);
+                  if (Parser::stops_on_conflicts && table[pos.state].stop_on_conflict(s, ll))
+                    return false;
+                  next_state = table[pos.state].reduce(s, ll);
+                  if (next_state != size_t(-1))
+                  {
+                    pos.state = next_state;
+                    pos.after_reduce = true;
+                    continue;
+                  }
+                }
+                else
+                {
+                  // the start rule has been reduced: the parse is done
+                  if (pos.state == 0 && s.size() == 1 && s.get_top_type() == SyntaxClass::grammar::start_rule)
+                    return false;
+
+                  pos.after_reduce = false;
+                  next_state = table[pos.state].go_to(s);
+                  if (next_state != size_t(-1))
+                  {
+                    pos.state = next_state;
+                    continue;
+                  }
+                }
+
+                next_state = table[pos.state].shift(s, ll);
+                if (next_state == size_t(-1))
+                {
+                  s.set_error_state(pos.state);
+                  Parser::tracer_policy_t::template on_error<SyntaxClass>(s.get_trace(), pos.state, ll.get_token());
+                  return false;
+                }
+                pos.state = next_state;
+                return true;
+              }
+            }
+
+            /// \brief Parse the whole input (not interleaved)
+            static void parse(uts_t &s, lexem_list<SyntaxClass> &ll)
+            {
+              position pos;
+              while (advance(s, ll, pos));
+            }
+
+            /// \brief Panic-mode error recovery, to be called when advance() has failed.
+            /// States are popped until one can shift the error token (error_token_type), the error token is shifted, and the input
+            /// is discarded until a token that the new state accepts is found.
+            /// \param skip_current Discard the current token first (used when the previous recovery hasn't consumed anything)
+            /// \return false if the parse can't be recovered (no state can shift an error token, the end of the input has been reached, ...)
+            static bool recover(uts_t &s, lexem_list<SyntaxClass> &ll, position &pos, const char *str, bool skip_current)
+            {
+              constexpr type_t error_type = static_cast<type_t>(error_token_type);
+              if (s.has_overflowed())
+                return false;
+
+              // pop the states until one can shift the error token
+              // (after a default reduction, pos.state is the state reached after it and the stack has the states under that one)
+              size_t next_state = table[pos.state].find_edge(error_type);
+              while (next_state == size_t(-1))
+              {
+                if (!s.size())
+                  return false;
+                pos.state = s.get_top_state();
+                s.pop();
+                next_state = table[pos.state].find_edge(error_type);
+              }
+
+              typename SyntaxClass::token_type error_token = ll.get_token();
+              error_token.type = error_type;
+              if (!s.push(error_type, pos.state, std::move(error_token)))
+                return false;
+              pos.state = next_state;
+              pos.after_reduce = false;
+              s.set_error_state(-1);
+
+              // discard the input until a token is accepted
+              const token_set<type_t> expected = expected_tokens_table<SyntaxClass, Parser>::table[pos.state];
+              while (skip_current || !(expected.contains(ll.get_token().type) || (expected.end_of_input && ll.is_last())))
+              {
+                skip_current = false;
+                const size_t index = ll.get_token().start_index > ll.get_start_index() ? ll.get_token().start_index : ll.get_start_index();
+                if (str[index] == '\0')
+                  return false;
+                // invalid tokens are skipped one character at a time
+                ll = ll.get_token().is_valid() ? ll.get_next() : lexem_list<SyntaxClass>(str, index + 1);
+              }
+              return true;
+            }
+
+          private:
+            struct entry
+            {
+              size_t (*reduce)(uts_t &, const lexem_list<SyntaxClass> &);
+              size_t (*shift)(uts_t &, lexem_list<SyntaxClass> &);
+              size_t (*go_to)(uts_t &);
+              size_t (*find_edge)(type_t);
+              bool (*stop_on_conflict)(uts_t &, const lexem_list<SyntaxClass> &);
+            };
+            static const entry table[sizeof...(States)];
+        };
+
+        template<typename SyntaxClass, typename Parser, typename... States>
+        const typename iterative_parser<SyntaxClass, Parser, ct::type_list<States...>>::entry iterative_parser<SyntaxClass, Parser, ct::type_list<States...>>::table[sizeof...(States)] =
+        {
+          {
+            &parser_state_step<SyntaxClass, States, Parser>::reduce,
+            &parser_state_step<SyntaxClass, States, Parser>::shift,
+            &parser_state_step<SyntaxClass, States, Parser>::go_to,
+            &parser_state_step<SyntaxClass, States, Parser>::find_edge,
+            &parser_state_step<SyntaxClass, States, Parser>::stop_on_conflict
+          }...
+        };
       } // namespace internal
     } // namespace alphyn
   } // namespace ct
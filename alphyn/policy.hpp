@@ -0,0 +1,64 @@
+//
+// file : policy.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_6380051132983983924_7677042__POLICY_HPP__
+# define __N_6380051132983983924_7677042__POLICY_HPP__
+
+#include <type_traits>
+
+// The policy mechanism of the parser: each policy has a kind (its policy_kind type), and the parser looks in its list of policies
+// for the one of each kind it needs (see parser.hpp). The policies themselves are in stack_policy.hpp, automaton_policy.hpp,
+// value_policy.hpp, statistics_policy.hpp and tracer_policy.hpp.
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief Retrieve the policy of the kind Kind in Policies, Default if there's none
+        template<typename Kind, typename Default, typename... Policies>
+        struct get_policy
+        {
+          using type = Default;
+        };
+
+        template<typename Kind, typename Default, typename Current, typename... Policies>
+        struct get_policy<Kind, Default, Current, Policies...>
+        {
+          using type = typename std::conditional
+          <
+            std::is_same<typename Current::policy_kind, Kind>::value,
+            Current,
+            typename get_policy<Kind, Default, Policies...>::type
+          >::type;
+        };
+      } // namespace internal
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_6380051132983983924_7677042__POLICY_HPP__*/
@@ -0,0 +1,260 @@
+//
+// file : push_parser.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1866126211304919783_2403718652__PUSH_PARSER_HPP__
+# define __N_1866126211304919783_2403718652__PUSH_PARSER_HPP__
+
+#include <string>
+#include <cstring>
+
+#include "parser.hpp"
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      /// \brief A push parser: instead of giving it the whole input at once, you feed it with chunks of input, as they arrive.
+      /// Between the calls to feed() the state of the parse is kept (the stacks, and the text of the token that may not be complete)
+      /// and only the text that is still needed is kept in memory.
+      /// \code
+      /// neam::ct::alphyn::push_parser<math_eval::parser, float> pp;
+      /// while (pp.feed(chunk, chunk_size) == pp.need_more_input) { /* read the next chunk */ }
+      /// if (pp.finish() == pp.done) float result = pp.get_result();
+      /// \endcode
+      /// \note A token is only shifted once the lexer has seen what's after it, so the last token (and the end of the parse) is only
+      ///       processed when finish() is called.
+      /// \note The tokens on the stack are updated when the buffer moves (their s/start_index/end_index members), but if your attributes keep
+      ///       pointers to the text of a token, those pointers are only valid until the next call to feed()
+      /// \note The lexer can't tell whether some text that isn't a token is the beginning of a token that continues in the next chunk
+      ///       (like an unterminated string). So an invalid token is only a syntax error once max_token_size bytes follow its start
+      ///       (or when finish() is called): a stray byte in the input is reported after at most max_token_size more bytes, not never.
+      template<typename Parser, typename ReturnType>
+      class push_parser
+      {
+        public:
+          using syntax_class = typename Parser::syntax_class;
+          using token_type = typename syntax_class::token_type;
+          using type_t = typename token_type::type_t;
+
+          enum status
+          {
+            need_more_input,  ///< \brief The parser needs more input (or a call to finish())
+            done,             ///< \brief The input has been parsed, the result is available
+            error,            ///< \brief A syntax error has been found (or the input buffer became too big)
+          };
+
+          /// \brief The default maximum size of a token (see the constructor)
+          static constexpr size_t default_max_token_size = 64 * 1024;
+
+        public:
+          /// \param max_buffer_size The maximum number of bytes the parser will keep (the text of the tokens on the stack and the input not processed yet).
+          ///                        Going beyond that limit is an error.
+          /// \param max_token_size The number of bytes after which some text the lexer can't read is no longer considered as the beginning of
+          ///                       a token (and is a syntax error). It must be bigger than the biggest token of your language.
+          explicit push_parser(size_t max_buffer_size = size_t(-1), size_t max_token_size = default_max_token_size)
+            : max_size(max_buffer_size), max_token(max_token_size)
+          {
+            // If you see this, your grammar has attributes that request the line index. The push parser only keeps the end of the input.
+            static_assert(!syntax_class::grammar::uses_line_index, "a push parser can't be used with grammars that use a line index");
+
+            reset();
+          }
+
+          push_parser(const push_parser &) = delete;
+          push_parser &operator = (const push_parser &) = delete;
+
+          /// \brief Start a new parse
+          void reset()
+          {
+            ctx.reset();
+            buffer.clear();
+            consumed = 0;
+            pos = typename iterative::position();
+            current_status = need_more_input;
+            finished = false;
+            buffer_full = false;
+            ll = lexem_list<syntax_class>(buffer.c_str(), 0);
+          }
+
+          /// \brief Set the user context given to the attributes that request it (it must be set after the reset() / before the first feed())
+          void set_user_context(typename Parser::user_context_t &user_context)
+          {
+            ctx.stack.set_user_context(&user_context);
+          }
+
+          /// \brief Give some input to the parser, and parse what can be parsed
+          status feed(const char *data, size_t size)
+          {
+            if (current_status != need_more_input || finished)
+              return current_status;
+
+            // remove what we don't need anymore and add the new input
+            size_t keep_from = ll.get_start_index();
+            for (size_t i = 0; i < ctx.stack.size(); ++i)
+            {
+              if (!non_terminals::is_non_terminal(ctx.stack.get_type(i)))
+              {
+                const size_t token_start = ctx.stack.template get<token_type>(i).start_index;
+                keep_from = token_start < keep_from ? token_start : keep_from;
+              }
+            }
+            const size_t lexer_index = ll.get_start_index() - keep_from;
+            buffer.erase(0, keep_from);
+            buffer.append(data, size);
+            consumed += keep_from;
+
+            // update the tokens in the stack
+            for (size_t i = 0; i < ctx.stack.size(); ++i)
+            {
+              if (!non_terminals::is_non_terminal(ctx.stack.get_type(i)))
+              {
+                token_type &tk = ctx.stack.template get<token_type>(i);
+                tk.s = buffer.c_str();
+                tk.start_index -= keep_from;
+                if (tk.end_index != size_t(-1))
+                  tk.end_index -= keep_from;
+              }
+            }
+            ll = lexem_list<syntax_class>(buffer.c_str(), lexer_index);
+
+            if (buffer.size() > max_size)
+            {
+              buffer_full = true;
+              current_status = error;
+              return current_status;
+            }
+            return run();
+          }
+
+          /// \brief Give some input to the parser
+          status feed(const std::string &data)
+          {
+            return feed(data.data(), data.size());
+          }
+
+          /// \brief Give some input to the parser
+          status feed(const char *data)
+          {
+            return feed(data, strlen(data));
+          }
+
+          /// \brief Tell the parser that there's no more input
+          status finish()
+          {
+            if (current_status != need_more_input || finished)
+              return current_status;
+            finished = true;
+            return run();
+          }
+
+          /// \brief Return the status of the parse
+          status get_status() const
+          {
+            return current_status;
+          }
+
+          /// \brief Return the result (the status must be done)
+          ReturnType &get_result()
+          {
+            return ctx.stack.template get<ReturnType>();
+          }
+
+          /// \brief Return the offset (from the beginning of the input) of the token that caused the error
+          size_t get_error_offset() const
+          {
+            return error_offset;
+          }
+
+          /// \brief Return true if the error is because the buffer became bigger than max_buffer_size
+          bool is_buffer_full() const
+          {
+            return buffer_full;
+          }
+
+          /// \brief Return the number of bytes currently kept by the parser
+          size_t get_buffer_size() const
+          {
+            return buffer.size();
+          }
+
+          /// \brief Return the context of the parser (with the arena)
+          typename Parser::context &get_context()
+          {
+            return ctx;
+          }
+
+        private:
+          /// \brief Advance the parse as much as possible
+          status run()
+          {
+            while (true)
+            {
+              // the lexer has to see what's after a token to be sure that the token is complete
+              // (and an invalid token may be the beginning of a valid one, unless it's already too big for that)
+              const token_type &tk = ll.get_token();
+              if (!finished && tk.is_valid() && tk.end_index >= buffer.size())
+                return need_more_input;
+              if (!finished && !tk.is_valid() && buffer.size() - tk.start_index < max_token)
+                return need_more_input;
+
+              if (!iterative::advance(ctx.stack, ll, pos))
+                break;
+            }
+
+            // the parse has ended
+            const bool has_succeeded = !ctx.stack.has_overflowed() && ctx.stack.size() == 1 && ctx.stack.get_top_type() == syntax_class::grammar::start_rule;
+            if (has_succeeded)
+              current_status = done;
+            else
+            {
+              current_status = error;
+              error_offset = consumed + ll.get_token().start_index;
+            }
+            return current_status;
+          }
+
+        private:
+          using iterative = internal::iterative_parser<syntax_class, Parser>;
+          using non_terminals = internal::non_terminal_checker<typename syntax_class::grammar::non_terminal_list>;
+
+          typename Parser::context ctx;
+          std::string buffer;
+          size_t consumed = 0; // the number of bytes removed from the buffer
+          size_t max_size;
+          size_t max_token;
+          typename iterative::position pos;
+          lexem_list<syntax_class> ll = lexem_list<syntax_class>("", 0);
+
+          status current_status = need_more_input;
+          size_t error_offset = 0;
+          bool finished = false;
+          bool buffer_full = false;
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1866126211304919783_2403718652__PUSH_PARSER_HPP__*/
@@ -0,0 +1,229 @@
+//
+// file : record_splitter.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1730563219084715243_2289017443__RECORD_SPLITTER_HPP__
+# define __N_1730563219084715243_2289017443__RECORD_SPLITTER_HPP__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define N_ALPHYN_SPLITTER_USE_SSE2
+#endif
+
+#include "grammar_attributes.hpp"
+#include "work_stealing.hpp"
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      /// \brief Describe how a text can be split in records, without lexing it (used by parser::parse_file_parallel)
+      /// \param Separator The byte that ends a record (like ';' or '\n'). It must only appear at the end of top-level records
+      ///                  (or in strings / comments).
+      /// \param Quote The byte that starts and ends a string ('\0' if there's no strings)
+      /// \param Escape The byte that escapes the next one in a string
+      /// \param LineComment The byte that starts a comment that ends at the end of the line ('\0' if there's no comments)
+      template<char Separator, char Quote = '\0', char Escape = '\\', char LineComment = '\0'>
+      struct split_syntax
+      {
+        static constexpr char separator = Separator;
+        static constexpr char quote = Quote;
+        static constexpr char escape = Escape;
+        static constexpr char line_comment = LineComment;
+      };
+
+      namespace internal
+      {
+        /// \brief Return the index of the first byte of [index, size[ that is one of Chars ('\0' are ignored), size if there's none
+        /// 16 bytes are tested at once when SSE2 is available.
+        template<char... Chars>
+        size_t find_first_of(const char *s, size_t index, size_t size)
+        {
+#ifdef N_ALPHYN_SPLITTER_USE_SSE2
+          for (; index + 16 <= size; index += 16)
+          {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + index));
+            const int masks[] = {0, (Chars ? _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(Chars))) : 0)...};
+            int mask = 0;
+            for (int m : masks)
+              mask |= m;
+            if (mask)
+            {
+              while (!(mask & 1))
+              {
+                mask >>= 1;
+                ++index;
+              }
+              return index;
+            }
+          }
+#endif
+          for (; index < size; ++index)
+          {
+            if (any_of((Chars && s[index] == Chars)...))
+              return index;
+          }
+          return size;
+        }
+
+        /// \brief Where the scan of a text is: outside of strings and comments, in a string, just after an escape byte in a string, in a comment
+        enum class split_scan_state : uint8_t
+        {
+          normal = 0,
+          string = 1,
+          escaped = 2,
+          comment = 3,
+        };
+
+        /// \brief For each state at the start of a piece of text, the state at its end
+        using split_scan_map = std::array<split_scan_state, 4>;
+
+        /// \brief The scan of a text for split_syntax (only the bytes that may change the state are looked at)
+        template<typename SplitSyntax>
+        struct split_scanner
+        {
+          static constexpr char sep = SplitSyntax::separator;
+          static constexpr char quote = SplitSyntax::quote;
+          // a doubled quote is simply the end of a string and the start of another one
+          static constexpr char escape = (quote && SplitSyntax::escape != quote ? SplitSyntax::escape : '\0');
+          static constexpr char comment = SplitSyntax::line_comment;
+          static constexpr char newline = (comment ? '\n' : '\0');
+
+          /// \brief Return the state after the byte \p c
+          static split_scan_state step(split_scan_state st, char c)
+          {
+            switch (st)
+            {
+              case split_scan_state::normal:
+                return (quote && c == quote) ? split_scan_state::string : ((comment && c == comment) ? split_scan_state::comment : st);
+              case split_scan_state::string:
+                return (escape && c == escape) ? split_scan_state::escaped : (c == quote ? split_scan_state::normal : st);
+              case split_scan_state::escaped:
+                return split_scan_state::string;
+              case split_scan_state::comment:
+                return c == '\n' ? split_scan_state::normal : st;
+            }
+            return st;
+          }
+
+          /// \brief Scan [index, end[ from every state at once
+          static split_scan_map run(const char *s, size_t index, size_t end)
+          {
+            split_scan_map map = {{split_scan_state::normal, split_scan_state::string, split_scan_state::escaped, split_scan_state::comment}};
+            while (index < end)
+            {
+              // the byte after an escape byte is skipped, whatever it is
+              if (map[0] != split_scan_state::escaped && map[1] != split_scan_state::escaped && map[2] != split_scan_state::escaped && map[3] != split_scan_state::escaped)
+              {
+                index = find_first_of<quote, escape, comment, newline>(s, index, end);
+                if (index == end)
+                  break;
+              }
+              for (split_scan_state &st : map)
+                st = step(st, s[index]);
+              ++index;
+            }
+            return map;
+          }
+
+          /// \brief Return the index just after the first separator of [index, size[ that is not in a string or a comment (\p st is the state at index),
+          /// size if there's none
+          static size_t next_split(const char *s, size_t index, size_t size, split_scan_state st)
+          {
+            while (index < size)
+            {
+              if (st != split_scan_state::escaped)
+              {
+                index = find_first_of<sep, quote, escape, comment, newline>(s, index, size);
+                if (index == size)
+                  break;
+              }
+              // the '\n' that ends a comment may be the separator
+              if (st == split_scan_state::comment && s[index] == '\n')
+                st = split_scan_state::normal;
+              if (st == split_scan_state::normal && s[index] == sep)
+                return index + 1;
+              st = step(st, s[index]);
+              ++index;
+            }
+            return size;
+          }
+        };
+
+        /// \brief Split [0, size[ in (at most) segment_count segments of roughly the same size, just after separators that are not
+        /// in a string or a comment.
+        /// Without strings and comments, the scan simply starts at each target offset and stops at the next separator.
+        /// Otherwise, the state (in a string, in a comment, ...) at each target has to be known: the pieces of text between the targets are
+        /// scanned in parallel (on \p thread_count threads) for every possible initial state, and the actual states are then chained, in order.
+        /// \return The boundaries of the segments (the first one is 0, the last one is size)
+        template<typename SplitSyntax>
+        std::vector<size_t> find_split_points(const char *s, size_t size, size_t segment_count, size_t thread_count = 1)
+        {
+          using scanner = split_scanner<SplitSyntax>;
+          if (!segment_count)
+            segment_count = 1;
+
+          std::vector<split_scan_state> states(segment_count, split_scan_state::normal);
+          if (SplitSyntax::quote || SplitSyntax::line_comment)
+          {
+            std::vector<split_scan_map> maps(segment_count - 1);
+            parallel_for_each_index(segment_count - 1, thread_count, [&](size_t, size_t i)
+            {
+              maps[i] = scanner::run(s, size * i / segment_count, size * (i + 1) / segment_count);
+            });
+            for (size_t i = 1; i < segment_count; ++i)
+              states[i] = maps[i - 1][size_t(states[i - 1])];
+          }
+
+          std::vector<size_t> ret;
+          ret.reserve(segment_count + 1);
+          ret.push_back(0);
+          for (size_t k = 1; k < segment_count; ++k)
+          {
+            const size_t target = size * k / segment_count;
+            // the previous split point is already after this target (no empty segments)
+            if (target < ret.back())
+              continue;
+            const size_t split = scanner::next_split(s, target, size, states[k]);
+            if (split >= size)
+              break;
+            ret.push_back(split);
+          }
+
+          if (ret.back() < size)
+            ret.push_back(size);
+          return ret;
+        }
+      } // namespace internal
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1730563219084715243_2289017443__RECORD_SPLITTER_HPP__*/
@@ -0,0 +1,207 @@
+//
+// file : stack_policy.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_11830215524713920374_2871640313__STACK_POLICY_HPP__
+# define __N_11830215524713920374_2871640313__STACK_POLICY_HPP__
+
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+#include "policy.hpp"
+
+// In this file are the different storage strategies for the parser stack (internal::tuple_stack).
+// A stack policy is simply given to the parser: \code parser<SyntaxClass, on_parse_error::throw_exception, checked_stack<128>> \endcode
+// (see parser.hpp for the policy mechanism).
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief The kind of the stack policies (see get_policy)
+        struct stack_policy_kind {};
+
+        /// \brief The allocator type of the stack policies that don't allocate
+        struct no_allocator {};
+
+        /// \brief An array that lives in the parser stack object (no dynamic allocation at all, can be used at compile-time)
+        /// If Checked is false, reserve() always succeeds (it's the responsibility of the user to provide a big enough capacity)
+        template<typename T, size_t Capacity, bool Checked>
+        class fixed_storage
+        {
+          public:
+            constexpr fixed_storage() = default;
+
+            /// \brief Make sure that \p count elements fit in the storage
+            constexpr bool reserve(size_t count)
+            {
+              return !Checked || count <= Capacity;
+            }
+
+            constexpr size_t capacity() const
+            {
+              return Capacity;
+            }
+
+            constexpr T &operator[](size_t index)
+            {
+              return data[index];
+            }
+            constexpr const T &operator[](size_t index) const
+            {
+              return data[index];
+            }
+
+          private:
+            T data[Capacity] = {};
+        };
+
+        /// \brief A storage that grows when it needs to (it uses the allocator provided by the user: a default-constructed one,
+        /// or the instance given to the constructor)
+        /// \note This storage can't be used at compile-time
+        template<typename T, typename Allocator, size_t InitialCapacity>
+        class growable_storage
+        {
+          public:
+            growable_storage() : data(InitialCapacity) {}
+
+            /// \brief Use \p allocator (rebound to T) for the memory of the storage
+            explicit growable_storage(const Allocator &allocator)
+              : data(typename std::allocator_traits<Allocator>::template rebind_alloc<T>(allocator))
+            {
+              data.resize(InitialCapacity);
+            }
+
+            /// \brief Make sure that \p count elements fit in the storage, growing it if needed
+            bool reserve(size_t count)
+            {
+              if (count > data.size())
+                data.resize(count > data.size() * 2 ? count : data.size() * 2);
+              return true;
+            }
+
+            size_t capacity() const
+            {
+              return data.size();
+            }
+
+            T &operator[](size_t index)
+            {
+              return data[index];
+            }
+            const T &operator[](size_t index) const
+            {
+              return data[index];
+            }
+
+          private:
+            std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>> data;
+        };
+
+        /// \brief The storage of the types that hold nothing (like the slots of the recognize_only policy): nothing is stored at all.
+        /// Every element is the same object
+        template<typename T>
+        class empty_storage
+        {
+          static_assert(std::is_empty<T>::value, "empty_storage can only store empty types");
+
+          public:
+            constexpr empty_storage() = default;
+            template<typename Allocator>
+            constexpr explicit empty_storage(const Allocator &) {}
+
+            constexpr bool reserve(size_t)
+            {
+              return true;
+            }
+
+            constexpr size_t capacity() const
+            {
+              return size_t(-1);
+            }
+
+            constexpr T &operator[](size_t)
+            {
+              return value;
+            }
+            constexpr const T &operator[](size_t) const
+            {
+              return value;
+            }
+
+          private:
+            T value = {};
+        };
+      } // namespace internal
+
+      /// \brief A fixed-size stack, without any bound checking
+      /// \param Capacity The maximum depth of the stack. If 0, the number of states of the canonical LR(1) automaton is used (the historical default,
+      ///                 kept with the lalr1 policy)
+      /// \note Exceeding the capacity is undefined behavior, so either use a very safe capacity or use checked_stack
+      template<size_t Capacity = 0>
+      struct fixed_stack
+      {
+        using policy_kind = internal::stack_policy_kind;
+        using allocator_type = internal::no_allocator;
+
+        template<typename T, size_t DefaultCapacity>
+        using storage = internal::fixed_storage<T, (Capacity ? Capacity : DefaultCapacity), false>;
+      };
+
+      /// \brief A fixed-size stack, with bound checking: the parse fails with an error when the capacity is exceeded
+      /// \param Capacity The maximum depth of the stack. If 0, the number of states of the canonical LR(1) automaton is used.
+      template<size_t Capacity = 0>
+      struct checked_stack
+      {
+        using policy_kind = internal::stack_policy_kind;
+        using allocator_type = internal::no_allocator;
+
+        template<typename T, size_t DefaultCapacity>
+        using storage = internal::fixed_storage<T, (Capacity ? Capacity : DefaultCapacity), true>;
+      };
+
+      /// \brief A stack that grows as needed, its memory is obtained from Allocator (that is rebound for the different types of the stack).
+      /// A stateful allocator (an arena, a pool, ...) is given to the parser context: \code parser::context ctx(my_allocator); \endcode
+      /// (contexts created without one use a default-constructed Allocator)
+      /// \note A parser using this policy can't be used at compile-time
+      template<typename Allocator = std::allocator<char>, size_t InitialCapacity = 64>
+      struct growable_stack
+      {
+        using policy_kind = internal::stack_policy_kind;
+        using allocator_type = Allocator;
+
+        static_assert(InitialCapacity > 0, "the initial capacity of a growable_stack must not be 0");
+
+        template<typename T, size_t /*DefaultCapacity*/>
+        using storage = internal::growable_storage<T, Allocator, InitialCapacity>;
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_11830215524713920374_2871640313__STACK_POLICY_HPP__*/
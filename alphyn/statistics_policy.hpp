@@ -0,0 +1,309 @@
+//
+// file : statistics_policy.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1322437651904357868_2818542733__STATISTICS_POLICY_HPP__
+# define __N_1322437651904357868_2818542733__STATISTICS_POLICY_HPP__
+
+#include <cstddef>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "policy.hpp"
+#include "grammar_tools.hpp" // for _rule_id
+
+// In this file are the policies that tell whether the parser records what it does (to tune a grammar).
+// Like the other policies, they are simply given to the parser:
+// \code parser<SyntaxClass, on_parse_error::throw_exception, collect_statistics> \endcode
+// The statistics are recorded in the parser context (see parser_context::get_statistics()).
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief The kind of the statistics policies (see get_policy)
+        struct statistics_policy_kind {};
+      } // namespace internal
+
+      /// \brief What the parser has done, for one or more parses (see collect_statistics)
+      /// \see parser::print_statistics()
+      struct parse_statistics
+      {
+        size_t parse_count = 0;       ///< \brief The number of parses
+        size_t token_count = 0;       ///< \brief The number of tokens read from the lexer (after shifting the end token, the parser reads one more)
+        size_t shift_count = 0;       ///< \brief The number of shifts
+        size_t reduction_count = 0;   ///< \brief The number of reductions
+        size_t max_stack_depth = 0;   ///< \brief The maximum number of symbols the stack has had
+        double lexing_time = 0;       ///< \brief The time spent in the lexer, in seconds (the first token of a parse is lexed before the parse starts, and isn't accounted)
+        double parsing_time = 0;      ///< \brief The time spent in the parser, in seconds (the lexing time excluded)
+
+        std::vector<size_t> reductions;   ///< \brief The number of reductions of each production rule (indexed by rule id, see grammar_tools::rule_id)
+        std::vector<size_t> state_visits; ///< \brief How many times each state has been entered (indexed like the automaton list of the parser)
+        std::vector<size_t> edge_visits;  ///< \brief How many times each edge (a shift or a goto) has been taken. The edges are indexed state
+                                          ///  after state, in the order of the edges of each state
+
+        /// \brief Set the number of rules, states and edges (and clear everything)
+        void resize(size_t rule_count, size_t state_count, size_t edge_count)
+        {
+          reductions.assign(rule_count, 0);
+          state_visits.assign(state_count, 0);
+          edge_visits.assign(edge_count, 0);
+          clear();
+        }
+
+        /// \brief Set every count to 0
+        void clear()
+        {
+          parse_count = 0;
+          token_count = 0;
+          shift_count = 0;
+          reduction_count = 0;
+          max_stack_depth = 0;
+          lexing_time = 0;
+          parsing_time = 0;
+          std::fill(reductions.begin(), reductions.end(), 0);
+          std::fill(state_visits.begin(), state_visits.end(), 0);
+          std::fill(edge_visits.begin(), edge_visits.end(), 0);
+        }
+
+        /// \brief Add the counts of \p o (they must come from the same parser)
+        parse_statistics &operator += (const parse_statistics &o)
+        {
+          parse_count += o.parse_count;
+          token_count += o.token_count;
+          shift_count += o.shift_count;
+          reduction_count += o.reduction_count;
+          max_stack_depth = std::max(max_stack_depth, o.max_stack_depth);
+          lexing_time += o.lexing_time;
+          parsing_time += o.parsing_time;
+          _add(reductions, o.reductions);
+          _add(state_visits, o.state_visits);
+          _add(edge_visits, o.edge_visits);
+          return *this;
+        }
+
+        private:
+          static void _add(std::vector<size_t> &dest, const std::vector<size_t> &src)
+          {
+            if (dest.size() < src.size())
+              dest.resize(src.size(), 0);
+            for (size_t i = 0; i < src.size(); ++i)
+              dest[i] += src[i];
+          }
+      };
+
+      /// \brief The statistics a parser context holds
+      class parser_statistics
+      {
+        public:
+          parse_statistics last;  ///< \brief The last parse
+          parse_statistics total; ///< \brief Every parse since the creation of the context (or the last call to clear())
+
+          /// \brief Set every count to 0
+          void clear()
+          {
+            last.clear();
+            total.clear();
+          }
+
+        private:
+          std::chrono::steady_clock::time_point parse_start;
+          double lexing_time_at_start = 0;
+
+          friend struct collect_statistics;
+      };
+
+      namespace internal
+      {
+        /// \brief What the parser context holds instead of a parser_statistics when the statistics are disabled: nothing
+        struct no_statistics_storage
+        {
+          constexpr void clear() {}
+        };
+
+        /// \brief Where a parser stack records its statistics (a base of tuple_stack). Storage is the statistics_storage of the policy.
+        template<typename Storage>
+        class stack_statistics
+        {
+          public:
+            /// \brief Set where the statistics are recorded (see collect_statistics)
+            constexpr void set_statistics(parser_statistics *_statistics)
+            {
+              statistics = _statistics;
+            }
+            constexpr parser_statistics *get_statistics() const
+            {
+              return statistics;
+            }
+
+          private:
+            parser_statistics *statistics = nullptr;
+        };
+
+        /// \brief Without statistics, the stack holds no pointer (this base is empty) and the hooks get nullptr
+        template<>
+        class stack_statistics<no_statistics_storage>
+        {
+          public:
+            constexpr void set_statistics(no_statistics_storage *) {}
+            constexpr parser_statistics *get_statistics() const
+            {
+              return nullptr;
+            }
+        };
+      } // namespace internal
+
+      /// \brief Don't record anything (the default): every hook is an empty function, and neither the stack nor the context hold anything
+      struct no_statistics
+      {
+        using policy_kind = internal::statistics_policy_kind;
+        static constexpr bool enabled = false;
+        /// \brief What the parser context holds
+        using statistics_storage = internal::no_statistics_storage;
+
+        template<typename Layout>
+        static constexpr void on_reset(statistics_storage *) {}
+        static constexpr void on_parse_begin(parser_statistics *) {}
+        static constexpr void on_parse_end(parser_statistics *) {}
+
+        template<typename LexemList>
+        static constexpr void next_token(parser_statistics *, LexemList &ll)
+        {
+          ll = ll.get_next();
+        }
+
+        static constexpr void on_enter_state(parser_statistics *, size_t) {}
+        template<typename Layout>
+        static constexpr void on_edge(parser_statistics *, size_t, size_t) {}
+        static constexpr void on_shift(parser_statistics *, size_t) {}
+        template<typename Rule>
+        static constexpr void on_reduce(parser_statistics *) {}
+      };
+
+      /// \brief Count the tokens, the shifts, the reductions of each rule, the visits of each state and each edge, the depth of the stack,
+      /// and time the lexer and the parser. Everything is recorded in the parser context: for the last parse, and since the creation of the context.
+      /// Parses made without a context record nothing.
+      /// \note Timing the lexer means reading the clock twice per token: the parse is a bit slower
+      /// \see parser_context::get_statistics(), parser::print_statistics()
+      struct collect_statistics
+      {
+        using policy_kind = internal::statistics_policy_kind;
+        static constexpr bool enabled = true;
+        /// \brief What the parser context holds
+        using statistics_storage = parser_statistics;
+
+        /// \brief Called by the context before each parse (the counts of the last parse are cleared)
+        template<typename Layout>
+        static void on_reset(parser_statistics *s)
+        {
+          if (s->total.state_visits.size() != Layout::state_count)
+            s->total.resize(Layout::rule_count, Layout::state_count, Layout::edge_count);
+          if (s->last.state_visits.size() != Layout::state_count)
+            s->last.resize(Layout::rule_count, Layout::state_count, Layout::edge_count);
+          else
+            s->last.clear();
+        }
+
+        static void on_parse_begin(parser_statistics *s)
+        {
+          if (!s)
+            return;
+          s->parse_start = clock::now();
+          s->lexing_time_at_start = s->last.lexing_time;
+          _update(s, [](parse_statistics &st) { ++st.parse_count; ++st.token_count; });
+        }
+
+        static void on_parse_end(parser_statistics *s)
+        {
+          if (!s)
+            return;
+          const double time = _seconds(clock::now() - s->parse_start) - (s->last.lexing_time - s->lexing_time_at_start);
+          _update(s, [time](parse_statistics &st) { st.parsing_time += time; });
+        }
+
+        template<typename LexemList>
+        static void next_token(parser_statistics *s, LexemList &ll)
+        {
+          if (!s)
+          {
+            ll = ll.get_next();
+            return;
+          }
+          const clock::time_point start = clock::now();
+          ll = ll.get_next();
+          const double time = _seconds(clock::now() - start);
+          _update(s, [time](parse_statistics &st) { st.lexing_time += time; ++st.token_count; });
+        }
+
+        static void on_enter_state(parser_statistics *s, size_t state_index)
+        {
+          _update(s, [state_index](parse_statistics &st) { ++st.state_visits[state_index]; });
+        }
+
+        /// \brief An edge (\p edge_index, in the edges of \p state_index) has been taken
+        template<typename Layout>
+        static void on_edge(parser_statistics *s, size_t state_index, size_t edge_index)
+        {
+          const size_t index = Layout::edge_offsets.data[state_index] + edge_index;
+          _update(s, [index](parse_statistics &st) { ++st.edge_visits[index]; });
+        }
+
+        static void on_shift(parser_statistics *s, size_t stack_depth)
+        {
+          _update(s, [stack_depth](parse_statistics &st) { ++st.shift_count; st.max_stack_depth = std::max(st.max_stack_depth, stack_depth); });
+        }
+
+        template<typename Rule>
+        static void on_reduce(parser_statistics *s)
+        {
+          constexpr size_t rule_id = internal::_rule_id<typename Rule::syntax_class, Rule::rule_name, typename Rule::as_type_list, typename Rule::attribute>::value;
+          _update(s, [](parse_statistics &st) { ++st.reduction_count; ++st.reductions[rule_id]; });
+        }
+
+        private:
+          using clock = std::chrono::steady_clock;
+
+          static double _seconds(clock::duration d)
+          {
+            return std::chrono::duration<double>(d).count();
+          }
+
+          template<typename Func>
+          static void _update(parser_statistics *s, Func &&func)
+          {
+            if (!s)
+              return;
+            func(s->last);
+            func(s->total);
+          }
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1322437651904357868_2818542733__STATISTICS_POLICY_HPP__*/
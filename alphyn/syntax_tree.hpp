@@ -0,0 +1,143 @@
+//
+// file : syntax_tree.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1764321985280335317_3314075924__SYNTAX_TREE_HPP__
+# define __N_1764321985280335317_3314075924__SYNTAX_TREE_HPP__
+
+#include <cstdint>
+#include <vector>
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      /// \brief A concrete syntax tree, stored flat: the nodes are in a single array, in post-order (the children of a node are before it,
+      /// the root is the last node), and the indexes of the children of each node are in a second array.
+      /// This is what a parser with the build_syntax_tree policy produces: each shifted token appends a leaf, and each reduction appends
+      /// a node whose children are the symbols of the rule (LR reductions are done in post-order, so there's nothing to sort).
+      /// Nothing is allocated per node, and the memory of the arrays is kept when the tree is cleared (so reusing a tree costs nothing).
+      /// \note Indexes and offsets are 32 bits: an input up to 4GB can be stored (a node takes 24 to 32 bytes, depending on type_t)
+      template<typename SyntaxClass>
+      class syntax_tree
+      {
+        public:
+          using type_t = typename SyntaxClass::token_type::type_t;
+          using index_t = uint32_t;
+
+          /// \brief The rule of the leaves (the tokens)
+          static constexpr index_t no_rule = index_t(-1);
+
+          struct node
+          {
+            index_t rule;         ///< \brief The id of the production rule (see grammar_tools::rule_id), no_rule for a token
+            index_t start_index;  ///< \brief The offset of the first character of the node in the input
+            index_t end_index;    ///< \brief The offset just after the last character of the node in the input
+            index_t first_child;  ///< \brief The index of the first child in the children array (see get_child())
+            index_t child_count;  ///< \brief The number of children (0 for a token)
+            type_t type;          ///< \brief The non-terminal (or the token type, for a token)
+
+            /// \brief Return true if the node is a token
+            constexpr bool is_token() const { return rule == no_rule; }
+          };
+
+        public:
+          /// \brief Remove every node (the memory is kept)
+          void clear()
+          {
+            nodes.clear();
+            children.clear();
+          }
+
+          /// \brief Make room for \p node_count nodes (children included: there's one child less than there's nodes)
+          void reserve(size_t node_count)
+          {
+            nodes.reserve(node_count);
+            children.reserve(node_count);
+          }
+
+          /// \brief Return the number of nodes
+          size_t size() const { return nodes.size(); }
+          /// \brief Return true if there's no nodes
+          bool empty() const { return nodes.empty(); }
+
+          /// \brief Return the root of the tree (the last node). The tree must not be empty !
+          const node &get_root() const { return nodes.back(); }
+          /// \brief Return the index of the root of the tree (the last node). The tree must not be empty !
+          index_t get_root_index() const { return index_t(nodes.size() - 1); }
+
+          const node &operator[](index_t index) const { return nodes[index]; }
+
+          /// \brief Return the index (in the node array) of the child \p child of \p n
+          index_t get_child_index(const node &n, index_t child) const { return children[n.first_child + child]; }
+          /// \brief Return the child \p child of \p n
+          const node &get_child(const node &n, index_t child) const { return nodes[children[n.first_child + child]]; }
+
+          /// \brief Iterate over the nodes, in post-order
+          const node *begin() const { return nodes.data(); }
+          const node *end() const { return nodes.data() + nodes.size(); }
+
+          /// \brief Return the node array (in post-order)
+          const std::vector<node> &get_nodes() const { return nodes; }
+          /// \brief Return the children array (node::first_child and node::child_count are a range in this array)
+          const std::vector<index_t> &get_children() const { return children; }
+
+        public: // used by the parser
+          /// \brief Add a leaf and return its index
+          /// \note You may never call this function
+          index_t add_token(type_t type, size_t start_index, size_t end_index)
+          {
+            nodes.push_back(node {no_rule, index_t(start_index), index_t(end_index), index_t(children.size()), 0, type});
+            return index_t(nodes.size() - 1);
+          }
+
+          /// \brief Add a node whose children are \p child_indexes, and return its index
+          /// \note You may never call this function
+          index_t add_rule(type_t type, size_t rule, const index_t *child_indexes, size_t child_count)
+          {
+            const index_t first_child = index_t(children.size());
+            children.insert(children.end(), child_indexes, child_indexes + child_count);
+            nodes.push_back(node
+            {
+              index_t(rule),
+              nodes[child_indexes[0]].start_index, nodes[child_indexes[child_count - 1]].end_index,
+              first_child, index_t(child_count),
+              type
+            });
+            return index_t(nodes.size() - 1);
+          }
+
+        private:
+          std::vector<node> nodes;
+          std::vector<index_t> children;
+      };
+
+      template<typename SyntaxClass>
+      constexpr typename syntax_tree<SyntaxClass>::index_t syntax_tree<SyntaxClass>::no_rule;
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1764321985280335317_3314075924__SYNTAX_TREE_HPP__*/
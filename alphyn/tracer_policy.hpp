@@ -0,0 +1,284 @@
+//
+// file : tracer_policy.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1170358208267433152_3525796102__TRACER_POLICY_HPP__
+# define __N_1170358208267433152_3525796102__TRACER_POLICY_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <tools/ct_list.hpp>
+
+#include "policy.hpp"
+#include "grammar_tools.hpp" // for _rule_id
+
+// In this file are the policies that trace what the parser does (to debug a grammar).
+// Like the other policies, they are simply given to the parser:
+// \code parser<SyntaxClass, on_parse_error::throw_exception, stderr_trace> \endcode
+// A tracer has hooks for when a state is entered, a token is shifted, a rule is reduced and a syntax error is found.
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief The kind of the tracer policies (see get_policy)
+        struct tracer_policy_kind {};
+
+        /// \brief Print a production rule: name -> symbols...
+        template<typename SyntaxClass, typename... Symbols>
+        void print_production(std::ostream &os, typename SyntaxClass::token_type::type_t name, const ct::type_list<Symbols...> *)
+        {
+          const typename SyntaxClass::token_type::type_t symbols[] = {name, Symbols::value...};
+          os << SyntaxClass::get_name_for_token_type(name) << " ->";
+          for (size_t i = 1; i < sizeof...(Symbols) + 1; ++i)
+            os << ' ' << SyntaxClass::get_name_for_token_type(symbols[i]);
+        }
+      } // namespace internal
+
+      /// \brief What a trace_event is
+      enum class trace_event_kind : uint8_t
+      {
+        enter_state,  ///< \brief A state has been entered (after a shift or a goto)
+        shift,        ///< \brief A token has been shifted
+        reduce,       ///< \brief A production rule has been reduced
+        error,        ///< \brief A syntax error (or a stack overflow) has been found
+      };
+
+      /// \brief An event recorded by the ring_buffer_trace tracer
+      struct trace_event
+      {
+        trace_event_kind kind;
+        uint32_t state;   ///< \brief The state where the event happened
+        uint32_t target;  ///< \brief For a reduction, the state the parser goes back to (-1 otherwise)
+        int64_t symbol;   ///< \brief For a shift or an error, the type of the token. For a reduction, the non-terminal
+        uint64_t value;   ///< \brief For a shift or an error, the offset of the token in the input. For a reduction, the id of the rule (see grammar_tools::rule_id)
+      };
+
+      /// \brief A ring buffer of trace_event: only the last capacity() events are kept (the capacity must be a power of 2)
+      /// \see parser::print_trace()
+      class trace_buffer
+      {
+        public:
+          explicit trace_buffer(size_t capacity = 0) : events(capacity) {}
+
+          /// \brief Add an event (the oldest one is lost if the buffer is full)
+          void push(const trace_event &event)
+          {
+            events[event_count & (events.size() - 1)] = event;
+            ++event_count;
+          }
+
+          /// \brief Remove every event, in O(1)
+          void clear()
+          {
+            event_count = 0;
+          }
+
+          /// \brief Return the number of events in the buffer
+          size_t size() const
+          {
+            return event_count < events.size() ? event_count : events.size();
+          }
+
+          /// \brief Return the number of events the buffer can hold
+          size_t capacity() const
+          {
+            return events.size();
+          }
+
+          /// \brief Return the number of events pushed since the last clear (size() of them are still there)
+          size_t get_event_count() const
+          {
+            return event_count;
+          }
+
+          /// \brief Return the event \p index, the oldest one being 0
+          const trace_event &operator[](size_t index) const
+          {
+            return events[(event_count - size() + index) & (events.size() - 1)];
+          }
+
+        private:
+          std::vector<trace_event> events;
+          size_t event_count = 0;
+      };
+
+      namespace internal
+      {
+        /// \brief What the parser context holds instead of a trace_buffer when the tracer doesn't record anything: nothing
+        struct no_trace_storage
+        {
+          constexpr explicit no_trace_storage(size_t) {}
+          constexpr void clear() {}
+        };
+
+        /// \brief Where a parser stack records its trace (a base of tuple_stack). Storage is the trace_storage of the policy.
+        template<typename Storage>
+        class stack_trace
+        {
+          public:
+            /// \brief Set where the trace is recorded (see ring_buffer_trace)
+            constexpr void set_trace(trace_buffer *_trace)
+            {
+              trace = _trace;
+            }
+            constexpr trace_buffer *get_trace() const
+            {
+              return trace;
+            }
+
+          private:
+            trace_buffer *trace = nullptr;
+        };
+
+        /// \brief Without a ring buffer, the stack holds no pointer (this base is empty) and the hooks get nullptr
+        template<>
+        class stack_trace<no_trace_storage>
+        {
+          public:
+            constexpr void set_trace(no_trace_storage *) {}
+            constexpr trace_buffer *get_trace() const
+            {
+              return nullptr;
+            }
+        };
+      } // namespace internal
+
+      /// \brief Don't trace anything (the default): every hook is an empty function, and neither the stack nor the context hold anything
+      struct no_trace
+      {
+        using policy_kind = internal::tracer_policy_kind;
+        /// \brief The capacity of the trace_buffer of the parser context
+        static constexpr size_t buffer_size = 0;
+        /// \brief What the parser context holds
+        using trace_storage = internal::no_trace_storage;
+
+        static constexpr void on_enter_state(trace_buffer *, size_t) {}
+        template<typename SyntaxClass, typename Token>
+        static constexpr void on_shift(trace_buffer *, size_t, const Token &) {}
+        template<typename Rule>
+        static constexpr void on_reduce(trace_buffer *, size_t, size_t) {}
+        template<typename SyntaxClass, typename Token>
+        static constexpr void on_error(trace_buffer *, size_t, const Token &) {}
+      };
+
+      /// \brief Print everything the parser does on stderr, with the names of the tokens and of the rules (SyntaxClass::get_name_for_token_type)
+      struct stderr_trace
+      {
+        using policy_kind = internal::tracer_policy_kind;
+        static constexpr size_t buffer_size = 0;
+        using trace_storage = internal::no_trace_storage;
+
+        static void on_enter_state(trace_buffer *, size_t state)
+        {
+          std::cerr << "S" << state << '\n';
+        }
+
+        template<typename SyntaxClass, typename Token>
+        static void on_shift(trace_buffer *, size_t state, const Token &token)
+        {
+          std::cerr << "  S" << state << " <- " << SyntaxClass::get_name_for_token_type(token.type);
+          _print_text(token);
+          std::cerr << '\n';
+        }
+
+        template<typename Rule>
+        static void on_reduce(trace_buffer *, size_t state, size_t target)
+        {
+          std::cerr << "  S" << state << ": reduce ";
+          internal::print_production<typename Rule::syntax_class>(std::cerr, Rule::rule_name, static_cast<const typename Rule::as_type_list *>(nullptr));
+          std::cerr << ", back to S" << target << '\n';
+        }
+
+        template<typename SyntaxClass, typename Token>
+        static void on_error(trace_buffer *, size_t state, const Token &token)
+        {
+          std::cerr << "  S" << state << ": syntax error on " << SyntaxClass::get_name_for_token_type(token.type) << " at " << token.start_index;
+          _print_text(token);
+          std::cerr << '\n';
+        }
+
+        private:
+          template<typename Token>
+          static void _print_text(const Token &token)
+          {
+            if (token.s && token.end_index != size_t(-1) && token.end_index > token.start_index)
+              std::cerr << " \"" << std::string(token.s + token.start_index, token.end_index - token.start_index) << '"';
+          }
+      };
+
+      /// \brief Record the last \p EventCount events in the trace_buffer of the parser context, to dump them when a parse fails
+      /// (see parser_context::get_trace() and parser::print_trace()). An event is 32 bytes, recording it is a store and an increment.
+      /// The buffer is cleared at the start of each parse, and parses made without a context record nothing.
+      template<size_t EventCount = 256>
+      struct ring_buffer_trace
+      {
+        static_assert(EventCount && !(EventCount & (EventCount - 1)), "the size of the ring buffer must be a power of 2");
+
+        using policy_kind = internal::tracer_policy_kind;
+        static constexpr size_t buffer_size = EventCount;
+        using trace_storage = trace_buffer;
+
+        static void on_enter_state(trace_buffer *buffer, size_t state)
+        {
+          _push(buffer, trace_event {trace_event_kind::enter_state, uint32_t(state), uint32_t(-1), 0, 0});
+        }
+
+        template<typename SyntaxClass, typename Token>
+        static void on_shift(trace_buffer *buffer, size_t state, const Token &token)
+        {
+          _push(buffer, trace_event {trace_event_kind::shift, uint32_t(state), uint32_t(-1), int64_t(token.type), uint64_t(token.start_index)});
+        }
+
+        template<typename Rule>
+        static void on_reduce(trace_buffer *buffer, size_t state, size_t target)
+        {
+          constexpr size_t rule_id = internal::_rule_id<typename Rule::syntax_class, Rule::rule_name, typename Rule::as_type_list, typename Rule::attribute>::value;
+          _push(buffer, trace_event {trace_event_kind::reduce, uint32_t(state), uint32_t(target), int64_t(Rule::rule_name), uint64_t(rule_id)});
+        }
+
+        template<typename SyntaxClass, typename Token>
+        static void on_error(trace_buffer *buffer, size_t state, const Token &token)
+        {
+          _push(buffer, trace_event {trace_event_kind::error, uint32_t(state), uint32_t(-1), int64_t(token.type), uint64_t(token.start_index)});
+        }
+
+        private:
+          static void _push(trace_buffer *buffer, const trace_event &event)
+          {
+            if (buffer)
+              buffer->push(event);
+          }
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1170358208267433152_3525796102__TRACER_POLICY_HPP__*/
@@ -0,0 +1,159 @@
+//
+// file : value_policy.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_3158640524226017946_1941063350__VALUE_POLICY_HPP__
+# define __N_3158640524226017946_1941063350__VALUE_POLICY_HPP__
+
+#include "policy.hpp"
+#include "grammar_tools.hpp" // for _rule_id
+#include "syntax_tree.hpp"
+
+// In this file are the policies that change what the parser does with the symbols it shifts and reduces.
+// Like the other policies, they are simply given to the parser:
+// \code parser<SyntaxClass, on_parse_error::throw_exception, build_syntax_tree> \endcode
+//
+// A value policy that doesn't compute values has:
+//  - slot<SyntaxClass, TypeList>, the type of what is stored in the parser stack for each symbol
+//  - output<SyntaxClass>, the type of what the parse produces (given to the parser with the input)
+//  - shift(output *, slot &, const token_type &), called when a token is shifted
+//  - reduce<Rule>(output *, slot *slots, size_t count), called when a rule is reduced: slots are the symbols of the rule,
+//    and what is in slots[0] after the call is the reduced symbol
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief The kind of the value policies (see get_policy)
+        struct value_policy_kind {};
+
+        /// \brief Nothing
+        struct no_value {};
+
+        /// \brief A range in the input
+        struct input_range
+        {
+          size_t start_index;
+          size_t end_index;
+        };
+      } // namespace internal
+
+      /// \brief The attributes are called and their values are kept in the parser stack (the default)
+      struct compute_values
+      {
+        using policy_kind = internal::value_policy_kind;
+        static constexpr bool computes_values = true;
+      };
+
+      /// \brief Don't call the attributes, don't keep any value: the parser only tells if the input is valid.
+      /// Only the state and type stacks are kept, and the lexer doesn't compute the values of the tokens if it can (see syntactic_unit).
+      /// \see parser::recognize()
+      struct recognize_only
+      {
+        using policy_kind = internal::value_policy_kind;
+        static constexpr bool computes_values = false;
+
+        template<typename SyntaxClass, typename TypeList>
+        using slot = internal::no_value;
+        template<typename SyntaxClass>
+        using output = internal::no_value;
+
+        template<typename Token>
+        static constexpr void shift(internal::no_value *, internal::no_value &, const Token &) {}
+
+        template<typename Rule>
+        static constexpr void reduce(internal::no_value *, internal::no_value *, size_t) {}
+      };
+
+      /// \brief Instead of calling the attributes, build a concrete syntax tree (see syntax_tree)
+      /// The parser stack only holds the index of the node of each symbol.
+      /// \note The unit rules bypassed by bypass_unit_rules have no node.
+      /// \see parser::build_tree()
+      struct build_syntax_tree
+      {
+        using policy_kind = internal::value_policy_kind;
+        static constexpr bool computes_values = false;
+
+        template<typename SyntaxClass, typename TypeList>
+        using slot = typename syntax_tree<SyntaxClass>::index_t;
+        template<typename SyntaxClass>
+        using output = syntax_tree<SyntaxClass>;
+
+        template<typename SyntaxClass, typename Token>
+        static void shift(syntax_tree<SyntaxClass> *tree, typename syntax_tree<SyntaxClass>::index_t &slot, const Token &token)
+        {
+          slot = tree->add_token(token.type, token.start_index, token.end_index);
+        }
+
+        template<typename Rule, typename SyntaxClass>
+        static void reduce(syntax_tree<SyntaxClass> *tree, typename syntax_tree<SyntaxClass>::index_t *slots, size_t count)
+        {
+          constexpr size_t rule_id = internal::_rule_id<SyntaxClass, Rule::rule_name, typename Rule::as_type_list, typename Rule::attribute>::value;
+          slots[0] = tree->add_rule(Rule::rule_name, rule_id, slots, count);
+        }
+      };
+
+      /// \brief Instead of calling the attributes, give an event to a sink for each shift and each reduction, as they happen (like SAX).
+      /// The parser stack only holds the range of the input of each symbol (so the memory only depends on the depth of the stack).
+      /// Sink must have those two functions:
+      /// \code
+      /// void on_shift(const token_type &token);
+      /// void on_reduce(type_t non_terminal, size_t rule_id, size_t start_index, size_t end_index); // rule_id: see grammar_tools::rule_id
+      /// \endcode
+      /// \note The unit rules bypassed by bypass_unit_rules have no event.
+      /// \see parser::parse_events()
+      template<typename Sink>
+      struct emit_events
+      {
+        using policy_kind = internal::value_policy_kind;
+        static constexpr bool computes_values = false;
+
+        template<typename SyntaxClass, typename TypeList>
+        using slot = internal::input_range;
+        template<typename SyntaxClass>
+        using output = Sink;
+
+        template<typename Token>
+        static void shift(Sink *sink, internal::input_range &slot, const Token &token)
+        {
+          slot = internal::input_range {token.start_index, token.end_index};
+          sink->on_shift(token);
+        }
+
+        template<typename Rule>
+        static void reduce(Sink *sink, internal::input_range *slots, size_t count)
+        {
+          constexpr size_t rule_id = internal::_rule_id<typename Rule::syntax_class, Rule::rule_name, typename Rule::as_type_list, typename Rule::attribute>::value;
+          slots[0].end_index = slots[count - 1].end_index;
+          sink->on_reduce(Rule::rule_name, rule_id, slots[0].start_index, slots[0].end_index);
+        }
+      };
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_3158640524226017946_1941063350__VALUE_POLICY_HPP__*/
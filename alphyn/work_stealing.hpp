@@ -0,0 +1,126 @@
+//
+// file : work_stealing.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1471621733160828029_3158823910__WORK_STEALING_HPP__
+# define __N_1471621733160828029_3158823910__WORK_STEALING_HPP__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <exception>
+
+namespace neam
+{
+  namespace ct
+  {
+    namespace alphyn
+    {
+      namespace internal
+      {
+        /// \brief Call fn(worker_index, item_index) for each item in [0, count[, using thread_count threads (the calling thread included).
+        /// Each worker starts with its own contiguous range of items and grabs chunks of it. When its range is empty, it steals
+        /// chunks from the ranges of the other workers. So no lock, and (almost) no contention while there's work to do in the own range.
+        /// If fn throws, the first exception is re-thrown in the calling thread once every worker has stopped.
+        /// \note fn must be callable concurrently from different threads (with different worker indexes)
+        template<typename Function>
+        void parallel_for_each_index(size_t count, size_t thread_count, Function &&fn)
+        {
+          if (!thread_count)
+            thread_count = std::thread::hardware_concurrency();
+          if (thread_count > count)
+            thread_count = count;
+          if (thread_count <= 1)
+          {
+            for (size_t i = 0; i < count; ++i)
+              fn(size_t(0), i);
+            return;
+          }
+
+          // avoid false sharing between the ranges of the workers
+          // (padding instead of alignas, as over-aligned new is not a thing before C++17)
+          struct range
+          {
+            std::atomic<size_t> next;
+            size_t end;
+            char _padding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+          };
+
+          std::unique_ptr<range[]> ranges(new range[thread_count]);
+          for (size_t i = 0; i < thread_count; ++i)
+          {
+            ranges[i].next = count * i / thread_count;
+            ranges[i].end = count * (i + 1) / thread_count;
+          }
+
+          // small chunks when there's few items (better balancing), bigger chunks when there's a lot of them (less atomic operations)
+          size_t chunk_size = count / (thread_count * 64);
+          chunk_size = chunk_size < 1 ? 1 : (chunk_size > 64 ? 64 : chunk_size);
+
+          std::atomic<bool> has_failed(false);
+          std::exception_ptr exception;
+
+          auto worker = [&](size_t worker_index)
+          {
+            try
+            {
+              for (size_t k = 0; k < thread_count && !has_failed; ++k)
+              {
+                // first our own range, then the ranges of the others
+                range &r = ranges[(worker_index + k) % thread_count];
+                while (!has_failed)
+                {
+                  const size_t begin = r.next.fetch_add(chunk_size, std::memory_order_relaxed);
+                  if (begin >= r.end)
+                    break;
+                  const size_t end = begin + chunk_size < r.end ? begin + chunk_size : r.end;
+                  for (size_t i = begin; i < end; ++i)
+                    fn(worker_index, i);
+                }
+              }
+            }
+            catch (...)
+            {
+              if (!has_failed.exchange(true))
+                exception = std::current_exception();
+            }
+          };
+
+          std::vector<std::thread> threads;
+          threads.reserve(thread_count - 1);
+          for (size_t i = 1; i < thread_count; ++i)
+            threads.emplace_back(worker, i);
+          worker(0);
+          for (std::thread &th : threads)
+            th.join();
+
+          if (exception)
+            std::rethrow_exception(exception);
+        }
+      } // namespace internal
+    } // namespace alphyn
+  } // namespace ct
+} // namespace neam
+
+#endif /*__N_1471621733160828029_3158823910__WORK_STEALING_HPP__*/
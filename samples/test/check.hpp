@@ -0,0 +1,54 @@
+//
+// file : check.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_3046082428712915594_2216312214__CHECK_HPP__
+# define __N_3046082428712915594_2216312214__CHECK_HPP__
+
+#include <cstddef>
+#include <iostream>
+
+// The behavior tests of the features of alphyn (see the test_*.hpp files). They are run by main() before the benchmarks.
+
+namespace tests
+{
+  /// \brief The number of checks that have failed
+  inline size_t &failure_count()
+  {
+    static size_t count = 0;
+    return count;
+  }
+
+  inline void check(bool result, const char *expr, const char *file, size_t line)
+  {
+    if (result)
+      return;
+    ++failure_count();
+    std::cerr << file << ':' << line << ": check failed: " << expr << std::endl;
+  }
+} // namespace tests
+
+/// \brief Check that the expression is true (a failed check is printed, and main() returns 1 once every test has run)
+#define ALPHYN_CHECK(...) tests::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+#endif /*__N_3046082428712915594_2216312214__CHECK_HPP__*/
@@ -5,159 +5,30 @@
 #include <default_token.hpp>
 
 #include <iostream>
+#include <thread>
 // #include <iomanip>
 
 #include "debug.hpp"
-
-/// \brief a simple mathematical evaluator
-struct math_eval
-{
-  using return_type = long;
-
-  // token relative things (type and invalid)
-  using token_type = neam::ct::alphyn::token<return_type>;
-  using type_t = typename token_type::type_t;
-
-  /// \brief possible "types" for a token
-  enum e_token_type : type_t
-  {
-    invalid = neam::ct::alphyn::invalid_token_type,
-
-    // tokens
-    tok_end         = 0,
-    tok_number      = 1,
-    tok_add         = 2,
-    tok_sub         = 3,
-    tok_mul         = 4,
-    tok_div         = 5,
-    tok_par_open    = 6,
-    tok_par_close   = 7,
-
-    // non-terminals
-    start   = 100,
-    expr    = 101,
-    sum     = 102,
-    prod    = 103,
-    val     = 104,
-  };
-
-  static std::string get_name_for_token_type(type_t t)
-  {
-    switch (t)
-    {
-      case math_eval::tok_end: return "tok_end";
-      case math_eval::tok_number: return "tok_number";
-      case math_eval::tok_add: return "tok_add";
-      case math_eval::tok_sub: return "tok_sub";
-      case math_eval::tok_mul: return "tok_mul";
-      case math_eval::tok_div: return "tok_div";
-      case math_eval::tok_par_open: return "tok_par_open";
-      case math_eval::tok_par_close: return "tok_par_close";
-      case math_eval::start: return "[start]";
-      case math_eval::expr: return "[expr]";
-      case math_eval::sum: return "[sum]";
-      case math_eval::prod: return "[prod]";
-      case math_eval::val: return "[val]";
-    }
-    return "[invalid]";
-  }
-
-  // THE LEXER THINGS //
-
-  // token builders
-  static constexpr token_type e_number(const char *s, size_t index, size_t end)
-  {
-    // a small strtof
-    float value = 0;
-    size_t i = index;
-    for (; s[i] != '.' && i < end; ++i)
-      value = value * 10 + (s[i] - '0');
-    if (s[i] == '.')
-    {
-      float cpow = 10;
-      for (size_t j = i + 1; j < end; ++j)
-      {
-        value += float(s[j] - '0') / cpow;
-        cpow *= 10;
-      }
-    }
-    return token_type {e_token_type::tok_number, return_type(value), s, index, end};
-  }
-
-  // regular expressions
-  constexpr static neam::string_t re_number = "[0-9]+(\\.[0-9]*)?";
-  constexpr static neam::string_t re_end = "$";
-
-  /// \brief The lexical syntax that will be used to tokenize a string (tokens are easier to parse)
-  using lexical_syntax = neam::ct::alphyn::lexical_syntax
-  <
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'+'>, token_type, token_type::generate_token_with_type<e_token_type::tok_add>>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'-'>, token_type, token_type::generate_token_with_type<e_token_type::tok_sub>>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'*'>, token_type, token_type::generate_token_with_type<e_token_type::tok_mul>>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'/'>, token_type, token_type::generate_token_with_type<e_token_type::tok_div>>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'('>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_open>>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<')'>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_close>>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_number>, token_type, e_number>,
-    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_end>, token_type, token_type::generate_token_with_type<e_token_type::tok_end>>
-  >;
-
-  /// \brief We simply want to skip white spaces
-  using skipper = neam::ct::alphyn::white_space_skipper;
-
-  /// \brief Finally, the lexer
-  using lexer = neam::ct::alphyn::lexer<math_eval>;
-
-  // THE PARSER THINGS //
-
-  /// \brief Shortcut for production_rule
-  template<typename Attribute, type_t... TokensOrRules>
-  using production_rule = neam::ct::alphyn::production_rule<math_eval, Attribute, TokensOrRules...>;
-  /// \brief Shortcut for production_rule_set
-  template<type_t Name, typename... Rules>
-  using production_rule_set = neam::ct::alphyn::production_rule_set<math_eval, Name, Rules...>;
-
-  /// \brief Because of the value_fallthrough_attribute we work on return_type directly
-  static constexpr return_type attr_add(return_type n1, const token_type &, return_type n2) { return n1 + n2; }
-  static constexpr return_type attr_sub(return_type n1, const token_type &, return_type n2) { return n1 - n2; }
-  static constexpr return_type attr_mul(return_type n1, const token_type &, return_type n2) { return n1 * n2; }
-  static constexpr return_type attr_div(return_type n1, const token_type &, return_type n2) { return n1 / n2; }
-
-  /// \brief The parser grammar
-  using grammar = neam::ct::alphyn::grammar<math_eval, start,
-    production_rule_set<start,
-      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
-    >,
-
-    production_rule_set<sum,
-      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
-      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
-      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
-    >,
-    production_rule_set<prod,
-      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
-      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
-      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
-    >,
-
-    production_rule_set<val,
-      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,               // val -> number
-      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
-    >
-  >;
-
-  /// \brief The parser. It parses things.
-  using parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::print_message/*call_error_handler*/>;
-
-  /// \brief A default handler
-  template<typename ReturnType>
-  static ReturnType on_parse_error(const char *string, size_t index)
-  {
-    static_assert(std::is_same<ReturnType, float>::value, "math_eval: the return type must be <float>");
-    std::cerr << "Could not parse the string: " << (string + index) << std::endl;
-    return ReturnType(-1);
-  }
-};
-
+#include "math_eval.hpp"
+#include "check.hpp"
+#include "test_glr.hpp"
+#include "test_syntax_tree.hpp"
+#include "test_events.hpp"
+#include "test_recognize.hpp"
+#include "test_line_index.hpp"
+#include "test_statistics.hpp"
+#include "test_trace.hpp"
+#include "test_stack.hpp"
+#include "test_move.hpp"
+#include "test_arena.hpp"
+#include "test_user_context.hpp"
+#include "test_push_parser.hpp"
+#include "test_records.hpp"
+#include "test_errors.hpp"
+#include "test_recovery.hpp"
+#include "test_unit_rules.hpp"
+#include "test_lalr.hpp"
+#include "test_precedence.hpp"
 
 // a test string:
 constexpr neam::string_t test_str = "2.0 * 4.0 + 4 / 2 + (4 * 2)";
@@ -175,8 +46,87 @@ int main(int /*argc*/, char **/*argv*/)
 
   std::cout << "res: " << math_eval::parser::parse_string<math_eval::return_type>("(1+1) * 2.5 + 5 / 2 * (3 - 0.5)") << '\n';
 
+  // the behavior tests of the features //
+  test_glr();
+  test_syntax_tree();
+  test_events();
+  test_recognize();
+  test_line_index();
+  test_statistics();
+  test_trace();
+  test_stack();
+  test_move();
+  test_arena();
+  test_user_context();
+  test_push_parser();
+  test_records();
+  test_errors();
+  test_recovery();
+  test_unit_rules();
+  test_lalr();
+  test_precedence();
+  if (tests::failure_count())
+  {
+    std::cerr << tests::failure_count() << " checks failed" << std::endl;
+    return 1;
+  }
+
 //   return 0;
 
+  // per-call overhead test (a lot of tiny strings) //
+  {
+    const std::string tiny_exprs[] = {"1 + 2", "3*4", "(5)", "6 / 2 - 1"};
+    constexpr size_t call_count = 4 * 1000 * 1000;
+    neam::cr::chrono chr;
+    long acc = 0;
+    for (size_t i = 0; i < call_count; ++i)
+      acc += math_eval::parser::parse_string<math_eval::return_type>(tiny_exprs[i % 4].c_str());
+    const double no_ctx_time = chr.delta();
+
+    // the same, but re-using a context (no stack construction on each call)
+    math_eval::parser::context ctx;
+    for (size_t i = 0; i < call_count; ++i)
+      acc -= math_eval::parser::parse_string<math_eval::return_type>(ctx, tiny_exprs[i % 4].c_str());
+    const double ctx_time = chr.delta();
+
+    std::cout << "tiny strings: " << (no_ctx_time * 1e9 / call_count) << "ns/call without context, "
+              << (ctx_time * 1e9 / call_count) << "ns/call with a context [check: " << acc << "]" << std::endl;
+
+    // the same, but in parallel (using every core)
+    std::vector<std::string> batch;
+    batch.reserve(call_count);
+    for (size_t i = 0; i < call_count; ++i)
+      batch.push_back(tiny_exprs[i % 4]);
+    std::vector<math_eval::return_type> results;
+    chr.delta();
+    const size_t error_count = math_eval::parser::parse_batch(batch, results).size();
+    const double batch_time = chr.delta();
+    std::cout << "tiny strings: " << (batch_time * 1e9 / call_count) << "ns/string with parse_batch (" << std::thread::hardware_concurrency()
+              << " threads, " << error_count << " errors)" << std::endl;
+
+    // one thread, but multiple strings are parsed at the same time (one token of each, in turn)
+    math_eval::parser::parse_interleaved<1>(batch, results);
+    const double interleaved_1_time = chr.delta();
+    math_eval::parser::parse_interleaved<8>(batch, results);
+    const double interleaved_8_time = chr.delta();
+    std::cout << "tiny strings: " << (interleaved_1_time * 1e9 / call_count) << "ns/string with parse_interleaved<1>, "
+              << (interleaved_8_time * 1e9 / call_count) << "ns/string with parse_interleaved<8>" << std::endl;
+  }
+
+  // GLR overhead test (an input that never forks) //
+  {
+    std::string glr_expr = "1";
+    for (size_t i = 0; i < 1000 * 1000; ++i) glr_expr += " + (0 * 1)";
+    neam::cr::chrono chr;
+    const auto lr_res = math_eval::parser::parse_string<math_eval::return_type>(glr_expr.c_str());
+    const double lr_time = chr.delta();
+    neam::ct::alphyn::glr_parser<math_eval>::context glr_ctx;
+    const auto glr_res = neam::ct::alphyn::glr_parser<math_eval>::parse_string<math_eval::return_type>(glr_ctx, glr_expr.c_str());
+    const double glr_time = chr.delta();
+    std::cout << "glr: " << glr_time << "s, parser: " << lr_time << "s [glr is " << (glr_time / lr_time) << "x slower"
+              << (glr_res && glr_res.get_value() == lr_res ? "" : ", DIFFERENT RESULT") << "]" << std::endl;
+  }
+
   // speed test //
   neam::cr::chrono chr;
   std::string expr = "1";
@@ -0,0 +1,222 @@
+//
+// file : test_arena.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1803227455112697_2907131844961__TEST_ARENA_HPP__
+# define __N_1803227455112697_2907131844961__TEST_ARENA_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief Logs its id when destructed
+struct destruction_logger
+{
+  destruction_logger(std::vector<int> &_log, int _id) : log(_log), id(_id) {}
+  ~destruction_logger() { log.push_back(id); }
+
+  std::vector<int> &log;
+  int id;
+};
+
+/// \brief A node of an expression tree, allocated in the arena. Counts the nodes that are alive.
+struct arena_tree_node
+{
+  static size_t &live_count()
+  {
+    static size_t count = 0;
+    return count;
+  }
+
+  explicit arena_tree_node(long _value) : value(_value) { ++live_count(); }
+  arena_tree_node(char _op, const arena_tree_node *_left, const arena_tree_node *_right) : op(_op), left(_left), right(_right) { ++live_count(); }
+  ~arena_tree_node() { --live_count(); }
+
+  long evaluate() const
+  {
+    switch (op)
+    {
+      case '+': return left->evaluate() + right->evaluate();
+      case '-': return left->evaluate() - right->evaluate();
+      case '*': return left->evaluate() * right->evaluate();
+      case '/': return left->evaluate() / right->evaluate();
+    }
+    return value;
+  }
+
+  char op = 0;
+  const arena_tree_node *left = nullptr;
+  const arena_tree_node *right = nullptr;
+  long value = 0;
+};
+
+/// \brief math_eval, but the attributes build a tree in the arena of the context
+struct arena_math_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<arena_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<arena_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<arena_math_eval, Name, Rules...>;
+
+  using node_ptr = const arena_tree_node *;
+
+  static node_ptr attr_number(neam::ct::alphyn::arena &a, const token_type &number) { return a.make<arena_tree_node>(number.value); }
+  static node_ptr attr_add(neam::ct::alphyn::arena &a, node_ptr n1, const token_type &, node_ptr n2) { return a.make<arena_tree_node>('+', n1, n2); }
+  static node_ptr attr_sub(neam::ct::alphyn::arena &a, node_ptr n1, const token_type &, node_ptr n2) { return a.make<arena_tree_node>('-', n1, n2); }
+  static node_ptr attr_mul(neam::ct::alphyn::arena &a, node_ptr n1, const token_type &, node_ptr n2) { return a.make<arena_tree_node>('*', n1, n2); }
+  static node_ptr attr_div(neam::ct::alphyn::arena &a, node_ptr n1, const token_type &, node_ptr n2) { return a.make<arena_tree_node>('/', n1, n2); }
+
+  using grammar = neam::ct::alphyn::grammar<arena_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_number), tok_number>,                                // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<arena_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief The arena, alone and through the parser context
+inline void test_arena()
+{
+  using neam::ct::alphyn::arena;
+
+  // block chaining: the blocks are kept (and re-used in the same order) after a reset
+  {
+    arena a(256);
+    std::vector<uint8_t *> first_pass;
+    for (size_t i = 0; i < 32; ++i)
+    {
+      uint8_t *ptr = static_cast<uint8_t *>(a.allocate(48));
+      memset(ptr, int(i), 48);
+      first_pass.push_back(ptr);
+    }
+    bool intact = true;
+    for (size_t i = 0; i < first_pass.size(); ++i)
+    {
+      for (size_t j = 0; j < 48; ++j)
+        intact = intact && first_pass[i][j] == uint8_t(i);
+    }
+    ALPHYN_CHECK(intact); // no allocation overlaps another one
+    ALPHYN_CHECK(first_pass.front() + 256 < first_pass.back() || first_pass.back() + 256 < first_pass.front()); // more than one block
+
+    a.reset();
+    bool same_addresses = true;
+    for (size_t i = 0; i < first_pass.size(); ++i)
+      same_addresses = same_addresses && a.allocate(48) == first_pass[i];
+    ALPHYN_CHECK(same_addresses);
+
+    // alignment
+    a.allocate(1, 1);
+    ALPHYN_CHECK(reinterpret_cast<uintptr_t>(a.allocate(8, 64)) % 64 == 0);
+  }
+
+  // allocations bigger than a block get their own block, that is kept for the next big allocation
+  {
+    arena a(256);
+    void *small = a.allocate(64);
+    uint8_t *big = static_cast<uint8_t *>(a.allocate(1000));
+    memset(big, 0xab, 1000);
+    void *small_after = a.allocate(64);
+    ALPHYN_CHECK(small != small_after && static_cast<void *>(big) != small_after);
+
+    a.reset();
+    ALPHYN_CHECK(a.allocate(64) == small);
+    ALPHYN_CHECK(a.allocate(1000) == big);
+    ALPHYN_CHECK(a.get_block_size() == 256);
+  }
+
+  // destructors are called in reverse order of construction, on reset() and when the arena is destroyed
+  {
+    std::vector<int> log;
+    {
+      arena a(256);
+      for (int i = 0; i < 3; ++i)
+        a.make<destruction_logger>(log, i);
+      ALPHYN_CHECK(log.empty());
+      a.reset();
+      ALPHYN_CHECK(log == std::vector<int>({2, 1, 0}));
+
+      // a second reset doesn't call them again
+      a.reset();
+      ALPHYN_CHECK(log.size() == 3);
+
+      for (int i = 10; i < 100; ++i) // spans more than one block
+        a.make<destruction_logger>(log, i);
+      log.clear();
+    }
+    bool reversed = log.size() == 90;
+    for (size_t i = 0; reversed && i < log.size(); ++i)
+      reversed = log[i] == 99 - int(i);
+    ALPHYN_CHECK(reversed);
+  }
+
+  // an `arena &` attribute, through the parser context
+  {
+    arena_tree_node::live_count() = 0;
+    {
+      arena_math_eval::parser::context ctx(256);
+      ALPHYN_CHECK(ctx.get_arena().get_block_size() == 256);
+
+      const auto result = arena_math_eval::parser::parse_string<arena_math_eval::node_ptr>(ctx, "1 + 2 * (3 - 4) / 2");
+      ALPHYN_CHECK(result.has_value() && result.get_value()->evaluate() == 0);
+      ALPHYN_CHECK(arena_tree_node::live_count() == 9);
+
+      // the arena is reset at the start of each parse: the previous tree is destructed
+      std::string long_input = "1";
+      for (size_t i = 0; i < 100; ++i)
+        long_input += " + 1";
+      const auto long_result = arena_math_eval::parser::parse_string<arena_math_eval::node_ptr>(ctx, long_input.c_str());
+      ALPHYN_CHECK(long_result.has_value() && long_result.get_value()->evaluate() == 101);
+      ALPHYN_CHECK(arena_tree_node::live_count() == 201);
+
+      // what an invalid input has allocated is also freed at the next parse
+      ALPHYN_CHECK(!arena_math_eval::parser::parse_string<arena_math_eval::node_ptr>(ctx, "1 + 2 +").has_value());
+      ALPHYN_CHECK(arena_math_eval::parser::parse_string<arena_math_eval::node_ptr>(ctx, "6 / 3").get_value()->evaluate() == 2);
+      ALPHYN_CHECK(arena_tree_node::live_count() == 3);
+    }
+    ALPHYN_CHECK(arena_tree_node::live_count() == 0);
+  }
+}
+
+#endif /*__N_1803227455112697_2907131844961__TEST_ARENA_HPP__*/
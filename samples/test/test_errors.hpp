@@ -0,0 +1,154 @@
+//
+// file : test_errors.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1327914903526655_2860431517735__TEST_ERRORS_HPP__
+# define __N_1327914903526655_2860431517735__TEST_ERRORS_HPP__
+
+#include <algorithm>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "test_records.hpp"
+#include "check.hpp"
+
+/// \brief statement_math_eval, but the input is a list of statements, and an invalid statement is skipped until its ';'
+/// (start -> stmts end, stmts -> stmt | stmts stmt, stmt -> sum ';' | error ';'). The result is the list of the values of the statements
+/// (-1000 for an invalid statement).
+struct recovering_math_eval : public statement_math_eval
+{
+  static constexpr type_t tok_error = neam::ct::alphyn::error_token_type;
+  static constexpr type_t statements = 105;
+  static constexpr type_t statement = 106;
+
+  using lexer = neam::ct::alphyn::lexer<recovering_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<recovering_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<recovering_math_eval, Name, Rules...>;
+
+  static std::vector<long> attr_first_statement(long value) { return std::vector<long>(1, value); }
+  static std::vector<long> attr_next_statement(std::vector<long> values, long value) { values.push_back(value); return values; }
+  static long attr_bad_statement(const token_type &, const token_type &) { return -1000; }
+
+  using grammar = neam::ct::alphyn::grammar<recovering_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, statements, tok_end>   // start -> stmts
+    >,
+    production_rule_set<statements,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_first_statement), statement>,              // stmts -> stmt
+      production_rule<ALPHYN_ATTRIBUTE(&attr_next_statement), statements, statement>   // stmts -> stmts stmt
+    >,
+    production_rule_set<statement,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_semicolon>,   // stmt -> sum ;
+      production_rule<ALPHYN_ATTRIBUTE(&attr_bad_statement), tok_error, tok_semicolon>  // stmt -> error ;
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,               // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<recovering_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief Return true if \p set has exactly the tokens of \p expected (in any order)
+template<typename TypeT>
+bool token_set_is(const neam::ct::alphyn::token_set<TypeT> &set, std::vector<TypeT> expected)
+{
+  std::vector<TypeT> tokens(set.begin(), set.end());
+  std::sort(tokens.begin(), tokens.end());
+  std::sort(expected.begin(), expected.end());
+  return tokens == expected;
+}
+
+/// \brief The on_parse_error::return_result error action, and the expected tokens of the states that reject a token
+inline void test_errors()
+{
+  using result_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+  using checked_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::checked_stack<4>>;
+
+  // the failure path is constexpr
+  static_assert(result_parser::parse_string<long>("1 + 2").has_value() && result_parser::parse_string<long>("1 + 2").get_value() == 3, "a valid input");
+  static_assert(!result_parser::parse_string<long>("1+").has_value(), "an invalid input is an error at compile-time");
+  static_assert(result_parser::parse_string<long>("1+").get_error().offset == 2, "the error is at the end of the input");
+  static_assert(result_parser::parse_string<long>("1+").get_error().token_type == math_eval::tok_end, "the end token was not expected");
+  static_assert(result_parser::parse_string<long>("1+").get_error().state == 3, "the state after 'sum +'");
+  static_assert(!result_parser::parse_string<long>("1+").get_error().stack_overflow, "not a stack overflow");
+  static_assert(result_parser::parse_string<long>("1)").get_error().offset == 1 && result_parser::parse_string<long>("1)").get_error().state == 30, "the ')'");
+  static_assert(result_parser::parse_string<long>("1 + #").get_error().token_type == neam::ct::alphyn::invalid_token_type, "an invalid token");
+  static_assert(result_parser::parse_string<long>("1 +").get_value_or(-1) == -1, "get_value_or gives the default value on failure");
+  static_assert(checked_parser::parse_string<long>("((((1))))").get_error().stack_overflow, "a stack overflow");
+  static_assert(checked_parser::parse_string<long>("((((1))))").get_error().offset == 4, "the 1 is the 5th symbol of the stack");
+
+  // the same at run-time, with and without a context
+  {
+    const auto result = result_parser::parse_string<long>("1+");
+    ALPHYN_CHECK(!result && !result.has_value());
+    ALPHYN_CHECK(result.get_error().offset == 2 && result.get_error().token_type == math_eval::tok_end);
+    ALPHYN_CHECK(result.get_error().state == 3 && !result.get_error().stack_overflow);
+
+    result_parser::context ctx;
+    const auto ctx_result = result_parser::parse_string<long>(ctx, "(4 * 2) 1");
+    ALPHYN_CHECK(!ctx_result && ctx_result.get_error().offset == 8 && ctx_result.get_error().token_type == math_eval::tok_number);
+    ALPHYN_CHECK(ctx_result.get_error().state == 30);
+    ALPHYN_CHECK(result_parser::parse_string<long>(ctx, "(4 * 2) + 1").get_value() == 9);
+  }
+
+  // the tokens that were expected where the parse has failed
+  {
+    using type_t = math_eval::type_t;
+    const auto after_add = result_parser::get_expected_tokens(result_parser::parse_string<long>("1+").get_error().state);
+    ALPHYN_CHECK(token_set_is<type_t>(after_add, {math_eval::tok_number, math_eval::tok_par_open}) && !after_add.end_of_input);
+    const auto after_number = result_parser::get_expected_tokens(result_parser::parse_string<long>("1)").get_error().state);
+    ALPHYN_CHECK(token_set_is<type_t>(after_number, {math_eval::tok_mul, math_eval::tok_div, math_eval::tok_add, math_eval::tok_sub, math_eval::tok_end}));
+    const auto in_par = result_parser::get_expected_tokens(result_parser::parse_string<long>("(1").get_error().state);
+    ALPHYN_CHECK(token_set_is<type_t>(in_par, {math_eval::tok_mul, math_eval::tok_div, math_eval::tok_add, math_eval::tok_sub, math_eval::tok_par_close}));
+    static_assert(result_parser::get_expected_tokens(0).size == 2 && result_parser::get_expected_tokens(0).contains(math_eval::tok_number), "the table is built at compile-time");
+
+    // the error token is never expected (even in the states that shift it)
+    using rec_parser = recovering_math_eval::parser;
+    bool has_error_token = false;
+    for (size_t i = 0; i < rec_parser::state_count; ++i)
+      has_error_token = has_error_token || rec_parser::get_expected_tokens(i).contains(recovering_math_eval::tok_error);
+    ALPHYN_CHECK(!has_error_token);
+    ALPHYN_CHECK(token_set_is<type_t>(rec_parser::get_expected_tokens(0), {math_eval::tok_number, math_eval::tok_par_open}));
+    const auto after_statement = rec_parser::get_expected_tokens(rec_parser::parse_string<std::vector<long>>("1; 2 2;").get_error().state);
+    ALPHYN_CHECK(token_set_is<type_t>(after_statement, {math_eval::tok_mul, math_eval::tok_div, math_eval::tok_add, math_eval::tok_sub, recovering_math_eval::tok_semicolon}));
+  }
+}
+
+#endif /*__N_1327914903526655_2860431517735__TEST_ERRORS_HPP__*/
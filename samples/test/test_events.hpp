@@ -0,0 +1,151 @@
+//
+// file : test_events.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1683712143785894383_2191178804__TEST_EVENTS_HPP__
+# define __N_1683712143785894383_2191178804__TEST_EVENTS_HPP__
+
+#include <string>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief A sink that writes the events it gets, like "shift tok_number [0,1)" or "reduce [val] 7 [0,1)"
+struct event_recorder
+{
+  void on_shift(const math_eval::token_type &token)
+  {
+    events.push_back("shift " + math_eval::get_name_for_token_type(token.type) + " " + range(token.start_index, token.end_index));
+  }
+
+  void on_reduce(math_eval::type_t non_terminal, size_t rule_id, size_t start_index, size_t end_index)
+  {
+    events.push_back("reduce " + math_eval::get_name_for_token_type(non_terminal) + " " + std::to_string(rule_id) + " " + range(start_index, end_index));
+  }
+
+  static std::string range(size_t start_index, size_t end_index)
+  {
+    return "[" + std::to_string(start_index) + "," + std::to_string(end_index) + ")";
+  }
+
+  std::vector<std::string> events;
+};
+
+/// \brief The emit_events policy
+inline void test_events()
+{
+  using event_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::emit_events<event_recorder>>;
+  using tools = neam::ct::alphyn::grammar_tools<math_eval>;
+
+  // the events come as the parser does the shifts and the reductions (so the reductions are in post-order)
+  {
+    event_recorder sink;
+    ALPHYN_CHECK(event_parser::parse_events(sink, "1 + 2 * 3"));
+    const std::vector<std::string> expected =
+    {
+      "shift tok_number [0,1)",
+      "reduce [val] 7 [0,1)",
+      "reduce [prod] 4 [0,1)",
+      "reduce [sum] 1 [0,1)",
+      "shift tok_add [2,3)",
+      "shift tok_number [4,5)",
+      "reduce [val] 7 [4,5)",
+      "reduce [prod] 4 [4,5)",
+      "shift tok_mul [6,7)",
+      "shift tok_number [8,9)",
+      "reduce [val] 7 [8,9)",
+      "reduce [prod] 5 [4,9)",
+      "reduce [sum] 2 [0,9)",
+      "shift tok_end [9,9)",
+      "reduce [start] 0 [0,9)",
+    };
+    ALPHYN_CHECK(sink.events == expected);
+    ALPHYN_CHECK(tools::rule_id<math_eval::prod, 1>::value == 5 && tools::rule_id<math_eval::sum, 1>::value == 2);
+  }
+
+  // the span of a reduction goes from the start of its first symbol to the end of its last one
+  {
+    event_recorder sink;
+    event_parser::context ctx;
+    ALPHYN_CHECK(event_parser::parse_events(ctx, sink, "  (10 -  2)/4  "));
+    const std::vector<std::string> expected =
+    {
+      "shift tok_par_open [2,3)",
+      "shift tok_number [3,5)",
+      "reduce [val] 7 [3,5)",
+      "reduce [prod] 4 [3,5)",
+      "reduce [sum] 1 [3,5)",
+      "shift tok_sub [6,7)",
+      "shift tok_number [9,10)",
+      "reduce [val] 7 [9,10)",
+      "reduce [prod] 4 [9,10)",
+      "reduce [sum] 3 [3,10)",
+      "shift tok_par_close [10,11)",
+      "reduce [val] 8 [2,11)",
+      "reduce [prod] 4 [2,11)",
+      "shift tok_div [11,12)",
+      "shift tok_number [12,13)",
+      "reduce [val] 7 [12,13)",
+      "reduce [prod] 6 [2,13)",
+      "reduce [sum] 1 [2,13)",
+      "shift tok_end [15,15)",
+      "reduce [start] 0 [2,15)",
+    };
+    ALPHYN_CHECK(sink.events == expected);
+  }
+
+  // with the unit rules bypassed, prod -> val has no event
+  {
+    using bypass_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::emit_events<event_recorder>,
+                                                   neam::ct::alphyn::bypass_unit_rules>;
+    event_recorder sink;
+    ALPHYN_CHECK(bypass_parser::parse_events(sink, "1 + 2"));
+    const std::vector<std::string> expected =
+    {
+      "shift tok_number [0,1)",
+      "reduce [val] 7 [0,1)",
+      "reduce [sum] 1 [0,1)",
+      "shift tok_add [2,3)",
+      "shift tok_number [4,5)",
+      "reduce [val] 7 [4,5)",
+      "reduce [sum] 2 [0,5)",
+      "shift tok_end [5,5)",
+      "reduce [start] 0 [0,5)",
+    };
+    ALPHYN_CHECK(sink.events == expected);
+  }
+
+  // on error, the events stop where the parse has stopped
+  {
+    event_recorder sink;
+    const auto result = event_parser::parse_events(sink, "1 + * 2");
+    ALPHYN_CHECK(!result);
+    ALPHYN_CHECK(result.get_error().offset == 4);
+    ALPHYN_CHECK(sink.events.size() == 5 && sink.events.back() == "shift tok_add [2,3)");
+  }
+}
+
+#endif /*__N_1683712143785894383_2191178804__TEST_EVENTS_HPP__*/
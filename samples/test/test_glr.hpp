@@ -0,0 +1,219 @@
+//
+// file : test_glr.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2100086664799448217_1083678__TEST_GLR_HPP__
+# define __N_2100086664799448217_1083678__TEST_GLR_HPP__
+
+#include <string>
+#include <random>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief math_eval with a flat (so ambiguous) grammar: the GLR parser keeps the derivation of the rule that comes first,
+/// so the order of the rules gives the precedence, and for the same rule the left-most reduction wins (left associativity)
+struct ambiguous_math_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<ambiguous_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<ambiguous_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<ambiguous_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<ambiguous_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, sum>,             // sum -> sum + sum
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, sum>,             // sum -> sum - sum
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), sum, tok_mul, sum>,             // sum -> sum * sum
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), sum, tok_div, sum>,             // sum -> sum / sum
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,              // sum -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>  // sum -> ( sum )
+    >
+  >;
+};
+
+/// \brief The same flat grammar, but every derivation is computed and merged: the result is the number of derivations
+struct derivation_count_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<derivation_count_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<derivation_count_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<derivation_count_eval, Name, Rules...>;
+
+  static return_type attr_one(const token_type &) { return 1; }
+  static return_type attr_combine(return_type n1, const token_type &, return_type n2) { return n1 * n2; }
+  static return_type merge_ambiguity(type_t, return_type &&first, return_type &&second) { return first + second; }
+
+  using grammar = neam::ct::alphyn::grammar<derivation_count_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_combine), sum, tok_add, sum>,         // sum -> sum + sum
+      production_rule<ALPHYN_ATTRIBUTE(&attr_one), tok_number>                      // sum -> number
+    >
+  >;
+};
+
+/// \brief A grammar that isn't LR(1): after "number +", the token after the '+' tells whether the number was a prod or a val
+struct lookahead_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<lookahead_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<lookahead_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<lookahead_eval, Name, Rules...>;
+
+  static return_type attr_prod_number(return_type n1, const token_type &, const token_type &n2) { return n1 + n2.value; }
+  static return_type attr_val_par(return_type n1, const token_type &, const token_type &, const token_type &n2, const token_type &) { return n1 + n2.value; }
+  static return_type attr_ten(const token_type &n) { return n.value * 10; }
+
+  using grammar = neam::ct::alphyn::grammar<lookahead_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, expr, tok_end>                         // start -> expr
+    >,
+    production_rule_set<expr,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_prod_number), prod, tok_add, tok_number>,                   // expr -> prod + number
+      production_rule<ALPHYN_ATTRIBUTE(&attr_val_par), val, tok_add, tok_par_open, tok_number, tok_par_close> // expr -> val + ( number )
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>  // prod -> number
+    >,
+    production_rule_set<val,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_ten), tok_number>                      // val -> number (times 10)
+    >
+  >;
+};
+
+/// \brief The GLR parser: ambiguities (chosen and merged), more than one token of lookahead, errors, and the same results as the parser
+inline void test_glr()
+{
+  using neam::ct::alphyn::glr_parser;
+
+  // ambiguous: the rule that comes first is kept
+  {
+    glr_parser<ambiguous_math_eval>::context ctx;
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "1 + 2 * 3").get_value() == 7);
+    ALPHYN_CHECK(ctx.get_ambiguity_count() == 1);
+    ALPHYN_CHECK(ctx.get_max_stack_count() > 1);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "2 * 3 + 1").get_value() == 7);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "8 - 2 * 3").get_value() == 2);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "8 - 2 - 1").get_value() == 5);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "16 / 4 / 2").get_value() == 2);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "(1 + 2) * 3").get_value() == 9);
+    ALPHYN_CHECK(ctx.get_ambiguity_count() == 0);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>("42").get_value() == 42);
+  }
+
+  // ambiguous, with a merge function: every derivation is counted (the Catalan numbers)
+  {
+    glr_parser<derivation_count_eval>::context ctx;
+    const long catalan[] = {1, 1, 2, 5, 14, 42, 132, 429};
+    std::string str = "1";
+    for (size_t i = 1; i < sizeof(catalan) / sizeof(catalan[0]); ++i)
+    {
+      str += " + 1";
+      const auto result = glr_parser<derivation_count_eval>::parse_string<long>(ctx, str.c_str());
+      ALPHYN_CHECK(result && result.get_value() == catalan[i]);
+    }
+    ALPHYN_CHECK(ctx.get_ambiguity_count() > 0);
+    ALPHYN_CHECK(glr_parser<derivation_count_eval>::parse_string<long>(ctx, "1").get_value() == 1);
+    ALPHYN_CHECK(ctx.get_ambiguity_count() == 0);
+  }
+
+  // two tokens of lookahead: the stack forks on the reduce/reduce conflict, and the wrong stack dies at the token after the '+'
+  {
+    glr_parser<lookahead_eval>::context ctx;
+    ALPHYN_CHECK(glr_parser<lookahead_eval>::parse_string<long>(ctx, "3 + 4").get_value() == 7);
+    ALPHYN_CHECK(ctx.get_max_stack_count() > 1);
+    ALPHYN_CHECK(ctx.get_ambiguity_count() == 0);
+    ALPHYN_CHECK(glr_parser<lookahead_eval>::parse_string<long>(ctx, "3 + (4)").get_value() == 34);
+    ALPHYN_CHECK(ctx.get_max_stack_count() > 1);
+    ALPHYN_CHECK(!glr_parser<lookahead_eval>::parse_string<long>(ctx, "3 + 4)"));
+
+    // the LR(1) parser only sees one of them
+    using lr_parser = neam::ct::alphyn::parser<lookahead_eval, neam::ct::alphyn::on_parse_error::return_result>;
+    ALPHYN_CHECK(!lr_parser::parse_string<long>("3 + 4") || !lr_parser::parse_string<long>("3 + (4)"));
+  }
+
+  // the parser parses the input until the first conflict, then its stack (with the values on it) is taken over
+  {
+    glr_parser<ambiguous_math_eval>::context ctx;
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "((2 * 3) + (4 - 1)) * 2 + 1 * 3").get_value() == 21);
+    ALPHYN_CHECK(ctx.get_max_stack_count() > 1);
+    ALPHYN_CHECK(glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "((2 * 3) + (4 - 1))").get_value() == 9);
+    ALPHYN_CHECK(ctx.get_max_stack_count() == 1);
+    const auto result = glr_parser<ambiguous_math_eval>::parse_string<long>(ctx, "(1 + (2 * 3) 4)");
+    ALPHYN_CHECK(!result && result.get_error().offset == 13);
+
+    // the conflicts stop the parser like syntax errors
+    using stopping_parser = neam::ct::alphyn::parser<lookahead_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::stop_on_conflicts>;
+    const auto stopped = stopping_parser::parse_string<long>("3 + 4");
+    ALPHYN_CHECK(!stopped && stopped.get_error().offset == 2 && stopped.get_error().token_type == math_eval::tok_add);
+    ALPHYN_CHECK((neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::stop_on_conflicts>::parse_string<long>("1 + 2 * 3").get_value() == 7));
+  }
+
+  // errors: a parse_error, where every stack has died
+  {
+    const auto result = glr_parser<ambiguous_math_eval>::parse_string<long>("1 + * 2");
+    ALPHYN_CHECK(!result);
+    ALPHYN_CHECK(result.get_error().offset == 4);
+    ALPHYN_CHECK(result.get_error().token_type == math_eval::tok_mul);
+    const auto result_end = glr_parser<ambiguous_math_eval>::parse_string<long>("(1 + 2");
+    ALPHYN_CHECK(!result_end);
+    ALPHYN_CHECK(result_end.get_error().token_type == math_eval::tok_end);
+    ALPHYN_CHECK(!glr_parser<math_eval>::parse_string<long>("1 2"));
+  }
+
+  // an unambiguous grammar: same results as the parser, and it never forks
+  {
+    glr_parser<math_eval>::context ctx;
+    std::minstd_rand rng(42);
+    const char *ops[] = {" + ", " - ", " * ", " / "};
+    for (size_t i = 0; i < 200; ++i)
+    {
+      std::string str = std::to_string(rng() % 10);
+      for (size_t j = rng() % 12; j > 0; --j)
+      {
+        str += ops[rng() % 4];
+        str += (rng() % 4 ? std::to_string(rng() % 9 + 1) : "(" + std::to_string(rng() % 10 + 3) + " - " + std::to_string(rng() % 3) + ")");
+      }
+      const auto result = glr_parser<math_eval>::parse_string<long>(ctx, str.c_str());
+      ALPHYN_CHECK(result && result.get_value() == math_eval::parser::parse_string<long>(str.c_str()));
+      ALPHYN_CHECK(ctx.get_max_stack_count() == 1);
+      ALPHYN_CHECK(ctx.get_ambiguity_count() == 0);
+    }
+  }
+}
+
+#endif /*__N_2100086664799448217_1083678__TEST_GLR_HPP__*/
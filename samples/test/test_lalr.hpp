@@ -0,0 +1,134 @@
+//
+// file : test_lalr.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1176534929861049730_2063948518__TEST_LALR_HPP__
+# define __N_1176534929861049730_2063948518__TEST_LALR_HPP__
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+#include "test_unit_rules.hpp"
+#include "test_records.hpp"
+
+/// \brief math_eval (with the ; of statement_math_eval), with a part that is LR(1) but not LALR(1): "+ 1" is reduced to plain or negated depending on what follows,
+/// and what follows each of them isn't the same after a "-". Merging the states after "+ 1" and "- + 1" gives a reduce/reduce conflict.
+struct lr1_only_math_eval : public statement_math_eval
+{
+  static constexpr type_t stmt = 105;
+  static constexpr type_t plain = 106;
+  static constexpr type_t negated = 107;
+  static constexpr type_t closed_negated = 108;
+  static constexpr type_t ended_negated = 109;
+
+  static constexpr return_type attr_plain(const token_type &, const token_type &t) { return t.value; }
+  static constexpr return_type attr_negate(const token_type &, const token_type &t) { return -t.value; }
+
+  using lexer = neam::ct::alphyn::lexer<lr1_only_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<lr1_only_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<lr1_only_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<lr1_only_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, stmt, tok_end>     // start -> stmt
+    >,
+    production_rule_set<stmt,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum>,                          // stmt -> sum
+      production_rule<neam::ct::alphyn::forward_first_attribute, plain, tok_semicolon>,         // stmt -> plain ;
+      production_rule<neam::ct::alphyn::forward_first_attribute, closed_negated>,               // stmt -> closed_negated
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_sub, plain, tok_par_close>,   // stmt -> - plain )
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_sub, ended_negated>           // stmt -> - ended_negated
+    >,
+    production_rule_set<closed_negated,
+      production_rule<neam::ct::alphyn::forward_first_attribute, negated, tok_par_close>  // closed_negated -> negated )
+    >,
+    production_rule_set<ended_negated,
+      production_rule<neam::ct::alphyn::forward_first_attribute, negated, tok_semicolon>  // ended_negated -> negated ;
+    >,
+    production_rule_set<plain,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_plain), tok_add, tok_number>           // plain -> + number
+    >,
+    production_rule_set<negated,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_negate), tok_add, tok_number>          // negated -> + number
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,               // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+};
+
+/// \brief The lalr1 policy
+inline void test_lalr()
+{
+  using neam::ct::alphyn::parser;
+  using neam::ct::alphyn::on_parse_error;
+  using neam::ct::alphyn::lalr1;
+
+  // math_eval: every state with the same core is merged
+  {
+    using merged = parser<math_eval, on_parse_error::return_result, lalr1>;
+    static_assert(merged::lr1_state_count == 31 && merged::state_count == 17, "the merged automaton of math_eval has 17 states");
+    static_assert(neam::ct::alphyn::grammar_tools<math_eval>::lalr1_merge::can_merge, "math_eval is LALR(1)");
+  }
+
+  // a grammar that isn't LALR(1): the conflicting states (and the ones that lead to them) are kept, the rest is merged
+  {
+    using canonical = parser<lr1_only_math_eval, on_parse_error::return_result>;
+    using merged = parser<lr1_only_math_eval, on_parse_error::return_result, lalr1>;
+    static_assert(!neam::ct::alphyn::grammar_tools<lr1_only_math_eval>::lalr1_merge::can_merge, "lr1_only_math_eval isn't LALR(1)");
+    // 47 states, 31 cores: the states after "+ 1" and after "+" (that leads to them) keep their two versions, the rest is merged
+    static_assert(canonical::state_count == 47 && merged::lr1_state_count == 47 && merged::state_count == 33, "a partial merge");
+
+    ALPHYN_CHECK(merged::parse_string<long>("+ 2 ;").get_value() == 2);
+    ALPHYN_CHECK(merged::parse_string<long>("+ 2 )").get_value() == -2);
+    ALPHYN_CHECK(merged::parse_string<long>("- + 2 ;").get_value() == -2);
+    ALPHYN_CHECK(merged::parse_string<long>("- + 2 )").get_value() == 2);
+    ALPHYN_CHECK(merged::parse_string<long>("1 + 2 * (3 - 1)").get_value() == 5);
+    ALPHYN_CHECK(!merged::parse_string<long>("+ 2 ; 3").has_value());
+    ALPHYN_CHECK(!merged::parse_string<long>("- 2").has_value());
+    ALPHYN_CHECK(!merged::parse_string<long>("- + 2").has_value());
+
+    std::mt19937 rng(41);
+    std::vector<std::string> inputs = {"+ 1 ;", "+ 1 )", "- + 1 ;", "- + 1 )", "- 1 ;", "+ (1) ;", "+ 1 + 1", "- + 1", "+ *", "-", "+ 1", "* 1"};
+    for (size_t i = 0; i < 1000; ++i)
+      inputs.push_back(random_maybe_broken_expression(rng));
+    ALPHYN_CHECK(parses_like<merged, canonical>(inputs));
+  }
+}
+
+#endif /*__N_1176534929861049730_2063948518__TEST_LALR_HPP__*/
@@ -0,0 +1,154 @@
+//
+// file : test_line_index.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_6994826388370279192_3438791401__TEST_LINE_INDEX_HPP__
+# define __N_6994826388370279192_3438791401__TEST_LINE_INDEX_HPP__
+
+#include <string>
+#include <vector>
+#include <random>
+
+#include <line_index.hpp>
+
+#include "check.hpp"
+
+/// \brief The position of every offset of \p str (and of the offset just after its end), by a plain scan
+inline std::vector<neam::ct::alphyn::text_position> naive_text_positions(const std::string &str)
+{
+  std::vector<neam::ct::alphyn::text_position> ret;
+  ret.reserve(str.size() + 1);
+  size_t line = 1;
+  size_t line_start = 0;
+  for (size_t i = 0; i <= str.size(); ++i)
+  {
+    ret.push_back(neam::ct::alphyn::text_position {line, i - line_start + 1});
+    if (i < str.size() && str[i] == '\n')
+    {
+      ++line;
+      line_start = i + 1;
+    }
+  }
+  return ret;
+}
+
+/// \brief Check every offset of \p str, in order and then backward (with a new index, that is then built from the end)
+inline bool line_index_matches_naive(const std::string &str, bool size_known)
+{
+  const std::vector<neam::ct::alphyn::text_position> expected = naive_text_positions(str);
+  neam::ct::alphyn::line_index forward(str.c_str(), size_known ? str.size() : size_t(-1));
+  neam::ct::alphyn::line_index backward(str.c_str(), size_known ? str.size() : size_t(-1));
+  for (size_t i = 0; i <= str.size(); ++i)
+  {
+    const neam::ct::alphyn::text_position fw = forward.get_position(i);
+    const size_t j = str.size() - i;
+    const neam::ct::alphyn::text_position bw = backward.get_position(j);
+    if (fw.line != expected[i].line || fw.column != expected[i].column || forward.get_line(i) != expected[i].line)
+      return false;
+    if (bw.line != expected[j].line || bw.column != expected[j].column)
+      return false;
+  }
+  return true;
+}
+
+/// \brief line_index::get_position, compared to a plain scan
+inline void test_line_index()
+{
+  using neam::ct::alphyn::line_index;
+  constexpr size_t block_size = line_index::block_size;
+
+  // a small string: offsets on the '\n', and just after them
+  {
+    const std::string str = "ab\n\ncd\n";
+    line_index lines(str.c_str(), str.size());
+    ALPHYN_CHECK(lines.get_position(0).line == 1 && lines.get_position(0).column == 1);
+    ALPHYN_CHECK(lines.get_position(2).line == 1 && lines.get_position(2).column == 3);   // the first '\n' ends the line 1
+    ALPHYN_CHECK(lines.get_position(3).line == 2 && lines.get_position(3).column == 1);   // the empty line
+    ALPHYN_CHECK(lines.get_position(4).line == 3 && lines.get_position(4).column == 1);
+    ALPHYN_CHECK(lines.get_position(7).line == 4 && lines.get_position(7).column == 1);   // the end of the string
+    ALPHYN_CHECK(lines.get_position(100).line == 4 && lines.get_position(100).column == 1); // clamped to the size
+    ALPHYN_CHECK(line_index_matches_naive(str, true) && line_index_matches_naive(str, false));
+    ALPHYN_CHECK(line_index_matches_naive("", true) && line_index_matches_naive("\n", true));
+  }
+
+  // '\n' right before, on, and right after the 4KB block boundaries and the 64 bytes chunks
+  {
+    for (const size_t nl : {size_t(63), size_t(64), size_t(65), block_size - 1, block_size, block_size + 1, 2 * block_size - 64, 2 * block_size})
+    {
+      std::string str(3 * block_size + 100, 'x');
+      str[nl] = '\n';
+      ALPHYN_CHECK(line_index_matches_naive(str, true));
+
+      line_index lines(str.c_str(), str.size());
+      ALPHYN_CHECK(lines.get_position(nl).line == 1 && lines.get_position(nl).column == nl + 1);
+      ALPHYN_CHECK(lines.get_position(nl + 1).line == 2 && lines.get_position(nl + 1).column == 1);
+      ALPHYN_CHECK(lines.get_position(str.size()).line == 2 && lines.get_position(str.size()).column == str.size() - nl);
+    }
+  }
+
+  // lines that are longer than a block (the last '\n' is some blocks before), and blocks full of '\n'
+  {
+    std::string str(block_size / 2, 'a');
+    str += '\n';
+    str += std::string(3 * block_size, 'b');
+    str += '\n';
+    str += std::string(block_size + 10, '\n');
+    str += std::string(2 * block_size + 1, 'c');
+    ALPHYN_CHECK(line_index_matches_naive(str, true));
+    ALPHYN_CHECK(line_index_matches_naive(str, false));
+
+    line_index lines(str.c_str());
+    const size_t offset = block_size / 2 + 1 + 2 * block_size + 5;
+    ALPHYN_CHECK(lines.get_position(offset).line == 2 && lines.get_position(offset).column == 2 * block_size + 6);
+  }
+
+  // random text (lines from 0 to 300 bytes, with a few long ones), and reset() to reuse an index
+  {
+    std::minstd_rand rng(4242);
+    std::string str;
+    while (str.size() < 12 * block_size)
+    {
+      const size_t line_size = rng() % 16 ? rng() % 300 : rng() % (2 * block_size);
+      for (size_t i = 0; i < line_size; ++i)
+        str += char('a' + rng() % 26);
+      str += '\n';
+    }
+    ALPHYN_CHECK(line_index_matches_naive(str, true));
+    ALPHYN_CHECK(line_index_matches_naive(str, false));
+
+    const std::vector<neam::ct::alphyn::text_position> expected = naive_text_positions(str);
+    line_index lines("first\nstring");
+    ALPHYN_CHECK(lines.get_position(8).line == 2 && lines.get_position(8).column == 3);
+    lines.reset(str.c_str(), str.size());
+    bool random_lookups_match = true;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+      const size_t offset = rng() % (str.size() + 1);
+      const neam::ct::alphyn::text_position pos = lines.get_position(offset);
+      random_lookups_match = random_lookups_match && pos.line == expected[offset].line && pos.column == expected[offset].column;
+    }
+    ALPHYN_CHECK(random_lookups_match);
+  }
+}
+
+#endif /*__N_6994826388370279192_3438791401__TEST_LINE_INDEX_HPP__*/
@@ -0,0 +1,120 @@
+//
+// file : test_move.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2784217355869155_1968232224278__TEST_MOVE_HPP__
+# define __N_2784217355869155_1968232224278__TEST_MOVE_HPP__
+
+#include <string>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief A list of numbers that counts how many times it has been copied (moves are free)
+struct copy_counting_list
+{
+  static size_t &copy_count()
+  {
+    static size_t count = 0;
+    return count;
+  }
+
+  copy_counting_list() = default;
+  copy_counting_list(const copy_counting_list &o) : numbers(o.numbers) { ++copy_count(); }
+  copy_counting_list(copy_counting_list &&) = default;
+  copy_counting_list &operator = (const copy_counting_list &o) { numbers = o.numbers; ++copy_count(); return *this; }
+  copy_counting_list &operator = (copy_counting_list &&) = default;
+
+  std::vector<long> numbers;
+};
+
+/// \brief Numbers separated by '+', as a list built by attributes that take it by value (or by rvalue-reference)
+struct list_math_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<list_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<list_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<list_math_eval, Name, Rules...>;
+
+  static copy_counting_list attr_first(const token_type &number)
+  {
+    copy_counting_list list;
+    list.numbers.push_back(number.value);
+    return list;
+  }
+  static copy_counting_list attr_append(copy_counting_list list, const token_type &, const token_type &number)
+  {
+    list.numbers.push_back(number.value);
+    return list;
+  }
+  static copy_counting_list attr_append_rvalue(copy_counting_list &&list, const token_type &, const token_type &number)
+  {
+    list.numbers.push_back(number.value);
+    return std::move(list);
+  }
+
+  using grammar = neam::ct::alphyn::grammar<list_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_first), tok_number>,                   // sum -> number
+      production_rule<ALPHYN_ATTRIBUTE(&attr_append), sum, tok_add, tok_number>,    // sum -> sum + number
+      production_rule<ALPHYN_ATTRIBUTE(&attr_append_rvalue), sum, tok_sub, tok_number> // sum -> sum - number
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<list_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief Values are moved between the parser stack and the attributes
+inline void test_move()
+{
+  // a list of 2000 numbers, appended by-value ('+') and by rvalue-reference ('-')
+  std::string input = "0";
+  for (size_t i = 1; i < 2000; ++i)
+    input += (i % 2 ? " + " : " - ") + std::to_string(i);
+
+  copy_counting_list::copy_count() = 0;
+  const auto result = list_math_eval::parser::parse_string<copy_counting_list>(input.c_str());
+  ALPHYN_CHECK(result.has_value());
+  ALPHYN_CHECK(result.get_value().numbers.size() == 2000);
+  ALPHYN_CHECK(result.get_value().numbers.front() == 0 && result.get_value().numbers.back() == 1999);
+  ALPHYN_CHECK(copy_counting_list::copy_count() == 0);
+
+  // the same with a context (its slots are re-used by move-assignation)
+  list_math_eval::parser::context ctx;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const auto ctx_result = list_math_eval::parser::parse_string<copy_counting_list>(ctx, input.c_str());
+    ALPHYN_CHECK(ctx_result.has_value() && ctx_result.get_value().numbers.size() == 2000);
+  }
+  ALPHYN_CHECK(copy_counting_list::copy_count() == 0);
+}
+
+#endif /*__N_2784217355869155_1968232224278__TEST_MOVE_HPP__*/
@@ -0,0 +1,300 @@
+//
+// file : test_precedence.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_3046627171252397141_1962913254__TEST_PRECEDENCE_HPP__
+# define __N_3046627171252397141_1962913254__TEST_PRECEDENCE_HPP__
+
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <alphyn.hpp>
+#include <bnf.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+#include "test_unit_rules.hpp"
+
+/// \brief math_eval, with a single non-terminal for the expressions and the precedence of the operators (the grammar of the documentation)
+struct flat_math_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<flat_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<flat_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<flat_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<flat_math_eval, start,
+    neam::ct::alphyn::left_associative<flat_math_eval, tok_add, tok_sub>,           // the lowest precedence
+    neam::ct::alphyn::left_associative<flat_math_eval, tok_mul, tok_div>,           // the highest precedence
+
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, expr, tok_end>     // start -> expr
+    >,
+    production_rule_set<expr,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), expr, tok_add, expr>,            // expr -> expr + expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), expr, tok_sub, expr>,            // expr -> expr - expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), expr, tok_mul, expr>,            // expr -> expr * expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), expr, tok_div, expr>,            // expr -> expr / expr
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>, // expr -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, expr, tok_par_close>   // expr -> ( expr )
+    >
+  >;
+};
+
+/// \brief flat_math_eval, with a right-associative power operator (that has the highest precedence)
+struct power_math_eval : public flat_math_eval
+{
+  static constexpr type_t tok_pow = 9;
+
+  static constexpr return_type attr_pow(return_type n1, const token_type &, return_type n2)
+  {
+    return_type ret = 1;
+    for (return_type i = 0; i < n2; ++i)
+      ret *= n1;
+    return ret;
+  }
+
+  using lexical_syntax = neam::ct::alphyn::lexical_syntax
+  <
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'+'>, token_type, token_type::generate_token_with_type<e_token_type::tok_add>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'-'>, token_type, token_type::generate_token_with_type<e_token_type::tok_sub>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'*'>, token_type, token_type::generate_token_with_type<e_token_type::tok_mul>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'/'>, token_type, token_type::generate_token_with_type<e_token_type::tok_div>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'^'>, token_type, token_type::generate_token_with_type<tok_pow>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'('>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_open>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<')'>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_close>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_number>, token_type, e_number>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_end>, token_type, token_type::generate_token_with_type<e_token_type::tok_end>>
+  >;
+
+  using lexer = neam::ct::alphyn::lexer<power_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<power_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<power_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<power_math_eval, start,
+    neam::ct::alphyn::left_associative<power_math_eval, tok_add, tok_sub>,
+    neam::ct::alphyn::left_associative<power_math_eval, tok_mul, tok_div>,
+    neam::ct::alphyn::right_associative<power_math_eval, tok_pow>,
+
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, expr, tok_end>     // start -> expr
+    >,
+    production_rule_set<expr,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), expr, tok_add, expr>,            // expr -> expr + expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), expr, tok_sub, expr>,            // expr -> expr - expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), expr, tok_mul, expr>,            // expr -> expr * expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), expr, tok_div, expr>,            // expr -> expr / expr
+      production_rule<ALPHYN_ATTRIBUTE(&attr_pow), expr, tok_pow, expr>,            // expr -> expr ^ expr
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>, // expr -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, expr, tok_par_close>   // expr -> ( expr )
+    >
+  >;
+};
+
+/// \brief power_math_eval, written in BNF (with %left and %right)
+struct power_math_eval_bnf
+{
+  using return_type = long;
+  using token_type = neam::ct::alphyn::bnf::token_type;
+
+  static constexpr neam::string_t add_str = "add";
+  static constexpr neam::string_t sub_str = "sub";
+  static constexpr neam::string_t mul_str = "mul";
+  static constexpr neam::string_t div_str = "div";
+  static constexpr neam::string_t pow_str = "pow";
+  static constexpr neam::string_t atol_str = "atol";
+  static constexpr neam::string_t forward0_str = "forward:0";
+  static constexpr neam::string_t forward1_str = "forward:1";
+
+  static constexpr return_type attr_add(return_type n1, const token_type &, return_type n2) { return n1 + n2; }
+  static constexpr return_type attr_sub(return_type n1, const token_type &, return_type n2) { return n1 - n2; }
+  static constexpr return_type attr_mul(return_type n1, const token_type &, return_type n2) { return n1 * n2; }
+  static constexpr return_type attr_div(return_type n1, const token_type &, return_type n2) { return n1 / n2; }
+  static constexpr return_type attr_pow(return_type n1, const token_type &, return_type n2)
+  {
+    return_type ret = 1;
+    for (return_type i = 0; i < n2; ++i)
+      ret *= n1;
+    return ret;
+  }
+  static constexpr return_type attr_atol(const token_type &tok)
+  {
+    return_type value = 0;
+    for (size_t i = tok.start_index; i < tok.end_index; ++i)
+      value = value * 10 + (tok.s[i] - '0');
+    return value;
+  }
+
+  using attributes = neam::ct::alphyn::bnf::attribute_db<
+    neam::ct::alphyn::bnf::attribute_db_entry<add_str, ALPHYN_ATTRIBUTE(&attr_add)>,
+    neam::ct::alphyn::bnf::attribute_db_entry<sub_str, ALPHYN_ATTRIBUTE(&attr_sub)>,
+    neam::ct::alphyn::bnf::attribute_db_entry<mul_str, ALPHYN_ATTRIBUTE(&attr_mul)>,
+    neam::ct::alphyn::bnf::attribute_db_entry<div_str, ALPHYN_ATTRIBUTE(&attr_div)>,
+    neam::ct::alphyn::bnf::attribute_db_entry<pow_str, ALPHYN_ATTRIBUTE(&attr_pow)>,
+    neam::ct::alphyn::bnf::attribute_db_entry<atol_str, ALPHYN_ATTRIBUTE(&attr_atol)>,
+    neam::ct::alphyn::bnf::attribute_db_entry<forward0_str, neam::ct::alphyn::forward_attribute<0>>,
+    neam::ct::alphyn::bnf::attribute_db_entry<forward1_str, neam::ct::alphyn::forward_attribute<1>>
+  >;
+
+  static constexpr neam::string_t bnf_grammar = R"(
+    start ::= expr regexp:'$'             [forward:0];
+
+    %left '+' '-';
+    %left '*' '/';
+    %right '^';
+
+    expr  ::= expr '+' expr               [add]
+            | expr '-' expr               [sub]
+            | expr '*' expr               [mul]
+            | expr '/' expr               [div]
+            | expr '^' expr               [pow]
+            | regexp:'[0-9]+'             [atol]
+            | '(' expr ')'                [forward:1];
+  )";
+};
+
+constexpr size_t sum_of(std::initializer_list<size_t> list)
+{
+  size_t ret = 0;
+  for (size_t it : list)
+    ret += it;
+  return ret;
+}
+
+/// \brief In the states of Automaton that can either reduce `expr Op expr` or shift Next, count the states (conflict_states)
+/// and the ones that reduce (reducing_states). The precedence levels are applied to State::final_rules (see _resolve_precedence)
+template<typename Automaton, math_eval::type_t Op, math_eval::type_t Next,
+         typename StateList = decltype(neam::ct::alphyn::internal::as_plain_type_list(static_cast<typename Automaton::as_type_list *>(nullptr)))>
+struct operator_conflict;
+template<typename Automaton, math_eval::type_t Op, math_eval::type_t Next, typename... States>
+struct operator_conflict<Automaton, Op, Next, neam::ct::type_list<States...>>
+{
+  using type_t = math_eval::type_t;
+  using elements = neam::ct::type_list<neam::embed::embed<type_t, math_eval::expr>, neam::embed::embed<type_t, Op>, neam::embed::embed<type_t, math_eval::expr>>;
+  using next = neam::embed::embed<type_t, Next>;
+
+  template<typename PRW> struct is_the_rule { static constexpr bool value = PRW::is_final && std::is_same<typename PRW::as_type_list, elements>::value; };
+  template<typename PRW> struct is_reduced_before_next { static constexpr bool value = is_the_rule<PRW>::value && neam::ct::is_in_list<typename PRW::follow_set, next>::value; };
+
+  template<typename State>
+  struct of_state
+  {
+    static constexpr bool has_conflict = neam::ct::is_in_list<typename State::transition_names, next>::value
+                                         && State::state_rules::template filter_by<is_the_rule>::size != 0;
+    static constexpr bool reduces = has_conflict && State::final_rules::template filter_by<is_reduced_before_next>::size != 0;
+  };
+
+  static constexpr size_t conflict_states = sum_of({size_t(0), size_t(of_state<States>::has_conflict)...});
+  static constexpr size_t reducing_states = sum_of({size_t(0), size_t(of_state<States>::reduces)...});
+
+  /// \brief true if `expr Op expr` is always reduced before a Next
+  static constexpr bool always_reduces = (conflict_states != 0 && reducing_states == conflict_states);
+  /// \brief true if Next is always shifted after `expr Op expr`
+  static constexpr bool always_shifts = (conflict_states != 0 && reducing_states == 0);
+};
+
+/// \brief left_associative / right_associative, and the %left / %right of the BNF meta-parser
+inline void test_precedence()
+{
+  using neam::ct::alphyn::parser;
+  using neam::ct::alphyn::on_parse_error;
+  using neam::ct::alphyn::lalr1;
+
+  // the precedence levels
+  {
+    using grammar = power_math_eval::grammar;
+    static_assert(grammar::token_precedence<math_eval::tok_add>::value == 1 && grammar::token_precedence<math_eval::tok_sub>::value == 1, "the lowest level");
+    static_assert(grammar::token_precedence<math_eval::tok_div>::value == 2 && grammar::token_precedence<power_math_eval::tok_pow>::value == 3, "the highest level");
+    static_assert(grammar::token_precedence<math_eval::tok_number>::value == 0, "no precedence");
+    static_assert(!grammar::token_precedence<math_eval::tok_mul>::is_right_associative && grammar::token_precedence<power_math_eval::tok_pow>::is_right_associative, "associativity");
+  }
+
+  // the shift/reduce conflicts are resolved in the automaton (_resolve_precedence)
+  {
+    using flat = neam::ct::alphyn::grammar_tools<flat_math_eval>::lr1_automaton;
+    static_assert(operator_conflict<flat, math_eval::tok_sub, math_eval::tok_sub>::always_reduces, "1 - 2 - 3 is (1 - 2) - 3");
+    static_assert(operator_conflict<flat, math_eval::tok_add, math_eval::tok_sub>::always_reduces, "the same level");
+    static_assert(operator_conflict<flat, math_eval::tok_add, math_eval::tok_mul>::always_shifts, "1 + 2 * 3 is 1 + (2 * 3)");
+    static_assert(operator_conflict<flat, math_eval::tok_mul, math_eval::tok_add>::always_reduces, "1 * 2 + 3 is (1 * 2) + 3");
+
+    using power = neam::ct::alphyn::grammar_tools<power_math_eval>::lr1_automaton;
+    static_assert(operator_conflict<power, power_math_eval::tok_pow, power_math_eval::tok_pow>::always_shifts, "2 ^ 3 ^ 2 is 2 ^ (3 ^ 2)");
+    static_assert(operator_conflict<power, math_eval::tok_mul, power_math_eval::tok_pow>::always_shifts, "2 * 3 ^ 2 is 2 * (3 ^ 2)");
+    static_assert(operator_conflict<power, power_math_eval::tok_pow, math_eval::tok_mul>::always_reduces, "2 ^ 3 * 2 is (2 ^ 3) * 2");
+  }
+
+  // the state counts of the documentation
+  {
+    static_assert(parser<flat_math_eval>::state_count == 27 && parser<flat_math_eval, on_parse_error::throw_exception, lalr1>::state_count == 15, "27 states (15 with lalr1)");
+    static_assert(parser<math_eval>::state_count == 31 && parser<math_eval, on_parse_error::throw_exception, lalr1>::state_count == 17, "31 states (17 with lalr1)");
+  }
+
+  // the values
+  {
+    using flat = parser<flat_math_eval, on_parse_error::return_result>;
+    static_assert(flat::parse_string<long>("1 - 2 - 3").get_value() == -4, "left associative");
+    static_assert(flat::parse_string<long>("1 + 2 * 3").get_value() == 7, "* before +");
+    ALPHYN_CHECK(flat::parse_string<long>("1 - 2 - 3").get_value() == -4);
+    ALPHYN_CHECK(flat::parse_string<long>("1 + 2 * 3").get_value() == 7);
+    ALPHYN_CHECK(flat::parse_string<long>("2 * 3 + 4").get_value() == 10);
+    ALPHYN_CHECK(flat::parse_string<long>("8 / 4 / 2").get_value() == 1);
+    ALPHYN_CHECK(flat::parse_string<long>("(1 + 2) * 3").get_value() == 9);
+
+    using power = parser<power_math_eval, on_parse_error::return_result>;
+    ALPHYN_CHECK(power::parse_string<long>("2 ^ 3 ^ 2").get_value() == 512);
+    ALPHYN_CHECK(power::parse_string<long>("(2 ^ 3) ^ 2").get_value() == 64);
+    ALPHYN_CHECK(power::parse_string<long>("2 * 3 ^ 2").get_value() == 18);
+    ALPHYN_CHECK(power::parse_string<long>("2 ^ 3 * 2").get_value() == 16);
+    ALPHYN_CHECK(power::parse_string<long>("1 - 2 - 3").get_value() == -4);
+    ALPHYN_CHECK(power::parse_string<long>("1 + 2 * 3").get_value() == 7);
+
+    // the same values and errors as the layered grammar
+    std::mt19937 rng(43);
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < 2000; ++i)
+      inputs.push_back(random_maybe_broken_expression(rng));
+    using layered = parser<math_eval, on_parse_error::return_result>;
+    ALPHYN_CHECK(parses_like<flat, layered>(inputs));
+    ALPHYN_CHECK(parses_like<parser<flat_math_eval, on_parse_error::return_result, lalr1>, layered>(inputs));
+    ALPHYN_CHECK(parses_like<power, layered>(inputs));
+  }
+
+  // %left and %right
+  {
+    using power_bnf = parser<neam::ct::alphyn::bnf::generate_parser<power_math_eval_bnf>, on_parse_error::return_result>;
+    ALPHYN_CHECK(power_bnf::parse_string<long>("1 - 2 - 3").get_value() == -4);
+    ALPHYN_CHECK(power_bnf::parse_string<long>("2 ^ 3 ^ 2").get_value() == 512);
+    ALPHYN_CHECK(power_bnf::parse_string<long>("1 + 2 * 3").get_value() == 7);
+    ALPHYN_CHECK(power_bnf::parse_string<long>("2 * 3 ^ 2 - 8 / 2 / 2").get_value() == 16);
+    static_assert(power_bnf::state_count == parser<power_math_eval>::state_count, "the same automaton as power_math_eval");
+  }
+}
+
+#endif /*__N_3046627171252397141_1962913254__TEST_PRECEDENCE_HPP__*/
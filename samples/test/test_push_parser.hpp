@@ -0,0 +1,217 @@
+//
+// file : test_push_parser.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_1450935412771321_3081930327162__TEST_PUSH_PARSER_HPP__
+# define __N_1450935412771321_3081930327162__TEST_PUSH_PARSER_HPP__
+
+#include <string>
+
+#include <alphyn.hpp>
+#include <push_parser.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief math_eval, but the parenthesis read the text of their tokens (that must still be right when the push parser has moved its buffer)
+struct text_reading_math_eval : public math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<text_reading_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<text_reading_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<text_reading_math_eval, Name, Rules...>;
+
+  /// \brief The value of the parenthesis, or -1000 if the text of a token is wrong
+  static return_type attr_par(const token_type &open, return_type n, const token_type &close)
+  {
+    if (open.s[open.start_index] != '(' || open.end_index != open.start_index + 1 || close.s[close.start_index] != ')')
+      return -1000;
+    return n;
+  }
+  /// \brief Return -1000 if the text of the operator is wrong
+  static return_type attr_add(return_type n1, const token_type &op, return_type n2)
+  {
+    return op.s[op.start_index] == '+' ? n1 + n2 : -1000;
+  }
+
+  using grammar = neam::ct::alphyn::grammar<text_reading_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,          // val -> number
+      production_rule<ALPHYN_ATTRIBUTE(&attr_par), tok_par_open, sum, tok_par_close>          // val -> ( sum )
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<text_reading_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief Feed \p str to \p pp in chunks of \p chunk_size bytes, then finish the parse
+template<typename PushParser>
+typename PushParser::status push_in_chunks(PushParser &pp, const std::string &str, size_t chunk_size)
+{
+  for (size_t i = 0; i < str.size(); i += chunk_size)
+  {
+    if (pp.feed(str.substr(i, chunk_size)) != pp.need_more_input)
+      return pp.get_status();
+  }
+  return pp.finish();
+}
+
+/// \brief The push parser
+inline void test_push_parser()
+{
+  using math_push_parser = neam::ct::alphyn::push_parser<text_reading_math_eval::parser, long>;
+
+  // feed() / finish()
+  {
+    math_push_parser pp;
+    ALPHYN_CHECK(pp.feed("1 + 2") == pp.need_more_input); // the 2 may continue in the next chunk
+    ALPHYN_CHECK(pp.finish() == pp.done);
+    ALPHYN_CHECK(pp.get_result() == 3);
+    ALPHYN_CHECK(pp.feed("+ 1") == pp.done && pp.finish() == pp.done); // nothing happens once the parse has ended
+
+    // reset() starts a new parse
+    pp.reset();
+    ALPHYN_CHECK(pp.get_status() == pp.need_more_input);
+    ALPHYN_CHECK(pp.feed("(4 * 2) ") == pp.need_more_input && pp.finish() == pp.done && pp.get_result() == 8);
+
+    // an empty input is an error
+    pp.reset();
+    ALPHYN_CHECK(pp.finish() == pp.error && pp.get_error_offset() == 0);
+  }
+
+  // tokens split across chunks: every chunk size gives the same result as parse_string
+  {
+    const std::string input = "12 * (3 + 40) - 7 * (2 + (10 / 5)) + 1234";
+    const long expected = text_reading_math_eval::parser::parse_string<long>(input.c_str()).get_value();
+    ALPHYN_CHECK(expected == 12 * 43 - 7 * 4 + 1234);
+    for (size_t chunk_size : {1, 2, 3, 5, 7, 100})
+    {
+      math_push_parser pp;
+      ALPHYN_CHECK(push_in_chunks(pp, input, chunk_size) == pp.done && pp.get_result() == expected);
+    }
+
+    // a number in three chunks
+    math_push_parser pp;
+    pp.feed("1");
+    pp.feed("23");
+    pp.feed("4 + 1");
+    ALPHYN_CHECK(pp.finish() == pp.done && pp.get_result() == 1235);
+  }
+
+  // the buffer is trimmed, and the tokens on the stack are rebased
+  {
+    math_push_parser pp;
+    std::string input = "1";
+    size_t max_buffer = 0;
+    pp.feed("1");
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      pp.feed(" + 1");
+      max_buffer = pp.get_buffer_size() > max_buffer ? pp.get_buffer_size() : max_buffer;
+    }
+    // the '(' and the '+' before it stay on the stack while their content is parsed
+    pp.feed(" + (");
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      pp.feed("2 + ");
+      max_buffer = pp.get_buffer_size() > max_buffer ? pp.get_buffer_size() : max_buffer;
+    }
+    pp.feed("2) + 1");
+    ALPHYN_CHECK(pp.finish() == pp.done);
+    ALPHYN_CHECK(pp.get_result() == 1001 + 2002 + 1); // -1000 somewhere if a token wasn't rebased
+    ALPHYN_CHECK(max_buffer < 4000 + 16); // not the whole input (more than 8000 bytes), but what follows the '(' is kept
+  }
+
+  // the error offset is from the beginning of the input, even when the buffer has been trimmed
+  {
+    math_push_parser pp;
+    ALPHYN_CHECK(pp.feed("1 + 2 + 3 + ") == pp.need_more_input);
+    ALPHYN_CHECK(pp.feed("4 + 5 + ") == pp.need_more_input);
+    ALPHYN_CHECK(pp.get_buffer_size() < 20);
+    ALPHYN_CHECK(pp.feed("* 6") == pp.error);
+    ALPHYN_CHECK(pp.get_error_offset() == 20 && !pp.is_buffer_full());
+    ALPHYN_CHECK(pp.finish() == pp.error);
+
+    math_push_parser pp_finish;
+    ALPHYN_CHECK(push_in_chunks(pp_finish, "(1 + 2", 2) == pp.error && pp_finish.get_error_offset() == 6); // at the end of the input
+  }
+
+  // max_buffer_size
+  {
+    math_push_parser pp(16);
+    ALPHYN_CHECK(pp.feed("(") == pp.need_more_input);
+    math_push_parser::status st = pp.need_more_input;
+    for (size_t i = 0; i < 100 && st == pp.need_more_input; ++i)
+      st = pp.feed("1 + ");
+    ALPHYN_CHECK(st == pp.error && pp.is_buffer_full());
+
+    // a long input that is not kept is not a problem
+    math_push_parser small_pp(16);
+    std::string input = "1";
+    for (size_t i = 0; i < 1000; ++i)
+      input += " + 1";
+    ALPHYN_CHECK(push_in_chunks(small_pp, input, 4) == pp.done && small_pp.get_result() == 1001 && !small_pp.is_buffer_full());
+  }
+
+  // an invalid byte: an error once enough input follows it (it can't be the beginning of a token), not an endless wait
+  {
+    math_push_parser pp(size_t(-1), 64);
+    ALPHYN_CHECK(pp.feed("1 + @ ") == pp.need_more_input);
+    math_push_parser::status st = pp.need_more_input;
+    size_t fed = 0;
+    for (; fed < 1000 && st == pp.need_more_input; ++fed)
+      st = pp.feed("2 3 4 ");
+    ALPHYN_CHECK(st == pp.error && !pp.is_buffer_full());
+    ALPHYN_CHECK(pp.get_error_offset() == 4);
+    ALPHYN_CHECK(fed * 6 < 64 + 6 && pp.get_buffer_size() < 64 + 6 + 4); // (the buffer starts at the + before the @)
+
+    // with the default limit too
+    math_push_parser default_pp;
+    st = default_pp.feed("1 + @ ");
+    for (fed = 0; fed < 100 * 1000 && st == pp.need_more_input; ++fed)
+      st = default_pp.feed("2 3 4 ");
+    ALPHYN_CHECK(st == pp.error && default_pp.get_error_offset() == 4);
+    ALPHYN_CHECK(default_pp.get_buffer_size() <= math_push_parser::default_max_token_size + 6);
+
+    // finish() doesn't wait
+    math_push_parser finish_pp;
+    ALPHYN_CHECK(finish_pp.feed("1 + @") == pp.need_more_input && finish_pp.finish() == pp.error && finish_pp.get_error_offset() == 4);
+  }
+}
+
+#endif /*__N_1450935412771321_3081930327162__TEST_PUSH_PARSER_HPP__*/
@@ -0,0 +1,149 @@
+//
+// file : test_recognize.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2688651697977516688_1428686715__TEST_RECOGNIZE_HPP__
+# define __N_2688651697977516688_1428686715__TEST_RECOGNIZE_HPP__
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief math_eval, but the numbers have a function that doesn't compute their value (used when the parser only recognizes the input),
+/// and the function that computes it counts its calls
+struct type_only_math_eval : public math_eval
+{
+  static size_t &number_value_count()
+  {
+    static size_t count = 0;
+    return count;
+  }
+
+  static token_type e_counted_number(const char *s, size_t index, size_t end)
+  {
+    ++number_value_count();
+    return e_number(s, index, end);
+  }
+
+  using lexical_syntax = neam::ct::alphyn::lexical_syntax
+  <
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'+'>, token_type, token_type::generate_token_with_type<e_token_type::tok_add>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'-'>, token_type, token_type::generate_token_with_type<e_token_type::tok_sub>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'*'>, token_type, token_type::generate_token_with_type<e_token_type::tok_mul>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'/'>, token_type, token_type::generate_token_with_type<e_token_type::tok_div>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'('>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_open>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<')'>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_close>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_number>, token_type, e_counted_number, token_type::generate_token_with_type<e_token_type::tok_number>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_end>, token_type, token_type::generate_token_with_type<e_token_type::tok_end>>
+  >;
+
+  using lexer = neam::ct::alphyn::lexer<type_only_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<type_only_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<type_only_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<type_only_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,               // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+};
+
+/// \brief The recognize_only policy
+inline void test_recognize()
+{
+  using recognizer = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::recognize_only>;
+
+  // at compile-time (like in the documentation)
+  static_assert(recognizer::recognize("1 + 2 * 3").has_value(), "works at compile-time too");
+  static_assert(!recognizer::recognize("1 + * 2").has_value(), "an invalid input is rejected at compile-time");
+  static_assert(!recognizer::recognize("((1 + 2)").has_value() && recognizer::recognize("((1 + 2)", 1).has_value(), "the start index is used");
+
+  // accept / reject
+  {
+    const char *valid[] = {"1", "1 + 2 * 3", "((((4))))", "  8 / 2 - (1.5 * 2)  ", "1-1-1-1-1"};
+    const char *invalid[] = {"", "1 +", "1 + * 2", "(1 + 2", "1 + 2)", "1 2", "()", "1 # 2"};
+    recognizer::context ctx;
+    for (const char *str : valid)
+    {
+      ALPHYN_CHECK(recognizer::recognize(str).has_value());
+      ALPHYN_CHECK(recognizer::recognize(ctx, str).has_value());
+    }
+    for (const char *str : invalid)
+    {
+      ALPHYN_CHECK(!recognizer::recognize(str).has_value());
+      ALPHYN_CHECK(!recognizer::recognize(ctx, str).has_value());
+    }
+
+    // the same parse_error as parse_string
+    using result_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+    const auto recognize_result = recognizer::recognize("1 + (2 * ) 3");
+    const auto parse_result = result_parser::parse_string<long>("1 + (2 * ) 3");
+    ALPHYN_CHECK(!recognize_result && !parse_result);
+    ALPHYN_CHECK(recognize_result.get_error().offset == parse_result.get_error().offset);
+    ALPHYN_CHECK(recognize_result.get_error().token_type == parse_result.get_error().token_type);
+    ALPHYN_CHECK(recognize_result.get_error().offset == 9);
+  }
+
+  // the lexer uses the type-only function of the numbers: their value is never computed
+  {
+    using type_only_recognizer = neam::ct::alphyn::parser<type_only_math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::recognize_only>;
+    using type_only_parser = neam::ct::alphyn::parser<type_only_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+
+    type_only_math_eval::number_value_count() = 0;
+    ALPHYN_CHECK(type_only_recognizer::recognize("1 + 2 * (3 - 4)").has_value());
+    ALPHYN_CHECK(!type_only_recognizer::recognize("1 + 2 3").has_value());
+    ALPHYN_CHECK(type_only_math_eval::number_value_count() == 0);
+
+    // but parse_string computes them
+    ALPHYN_CHECK(type_only_parser::parse_string<long>("1 + 2 * (3 - 4)").get_value() == -1);
+    ALPHYN_CHECK(type_only_math_eval::number_value_count() == 4);
+
+    // the lexer itself
+    long end_index = 0;
+    const auto token = type_only_math_eval::lexer::get_type_only_token(" 42 ", 0, end_index);
+    ALPHYN_CHECK(token.type == math_eval::tok_number && token.start_index == 1 && end_index == 3);
+    ALPHYN_CHECK(type_only_math_eval::number_value_count() == 4);
+    ALPHYN_CHECK(type_only_math_eval::lexer::get_token(" 42 ", 0, end_index).value == 42);
+    ALPHYN_CHECK(type_only_math_eval::number_value_count() == 5);
+  }
+}
+
+#endif /*__N_2688651697977516688_1428686715__TEST_RECOGNIZE_HPP__*/
@@ -0,0 +1,310 @@
+//
+// file : test_records.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2309827114563218_1193054471290__TEST_RECORDS_HPP__
+# define __N_2309827114563218_1193054471290__TEST_RECORDS_HPP__
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief math_eval, but a sentence ends with a ';' (start -> sum ';')
+struct statement_math_eval : public math_eval
+{
+  static constexpr type_t tok_semicolon = 8;
+
+  using lexical_syntax = neam::ct::alphyn::lexical_syntax
+  <
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'+'>, token_type, token_type::generate_token_with_type<e_token_type::tok_add>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'-'>, token_type, token_type::generate_token_with_type<e_token_type::tok_sub>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'*'>, token_type, token_type::generate_token_with_type<e_token_type::tok_mul>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'/'>, token_type, token_type::generate_token_with_type<e_token_type::tok_div>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<'('>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_open>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<')'>, token_type, token_type::generate_token_with_type<e_token_type::tok_par_close>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::letter<';'>, token_type, token_type::generate_token_with_type<tok_semicolon>>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_number>, token_type, e_number>,
+    neam::ct::alphyn::syntactic_unit<neam::ct::alphyn::regexp<re_end>, token_type, token_type::generate_token_with_type<e_token_type::tok_end>>
+  >;
+
+  using lexer = neam::ct::alphyn::lexer<statement_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<statement_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<statement_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<statement_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_semicolon> // start -> sum ;
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, val>              // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,               // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<statement_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief parse_prefix, at compile-time: return the value of the sentence at \p index (or its end index if \p get_end_index is true)
+constexpr long compile_time_prefix(const char *str, size_t index, bool get_end_index = false)
+{
+  size_t end_index = 0;
+  const long value = statement_math_eval::parser::parse_prefix<long>(str, index, end_index).get_value();
+  return get_end_index ? long(end_index) : value;
+}
+
+/// \brief The split points find_split_points should return, by a plain byte-by-byte scan of \p str
+/// (the first separator that is not in a string or a comment after each target, skipping the targets behind the previous split point)
+template<typename SplitSyntax>
+std::vector<size_t> naive_split_points(const std::string &str, size_t segment_count)
+{
+  // the offsets just after the separators that can split the text
+  std::vector<bool> can_split(str.size() + 1, false);
+  bool in_string = false;
+  bool in_comment = false;
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    const char c = str[i];
+    if (in_comment)
+      in_comment = (c != '\n');
+    else if (in_string)
+    {
+      if (c == SplitSyntax::escape && SplitSyntax::escape != SplitSyntax::quote)
+        ++i;
+      else if (c == SplitSyntax::quote)
+        in_string = false;
+      continue;
+    }
+    if (in_comment)
+      continue;
+    if (c == SplitSyntax::separator)
+      can_split[i + 1] = true;
+    else if (SplitSyntax::quote && c == SplitSyntax::quote)
+      in_string = true;
+    else if (SplitSyntax::line_comment && c == SplitSyntax::line_comment)
+      in_comment = true;
+  }
+
+  std::vector<size_t> ret = {0};
+  for (size_t k = 1; k < segment_count; ++k)
+  {
+    const size_t target = str.size() * k / segment_count;
+    if (target < ret.back())
+      continue;
+    size_t split = target + 1;
+    while (split < str.size() && !can_split[split])
+      ++split;
+    if (split >= str.size())
+      break;
+    ret.push_back(split);
+  }
+  if (ret.back() < str.size())
+    ret.push_back(str.size());
+  return ret;
+}
+
+/// \brief Compare find_split_points to naive_split_points on random texts made of \p alphabet
+template<typename SplitSyntax>
+bool split_points_match_naive(const char *alphabet, size_t thread_count)
+{
+  std::mt19937 rng(42);
+  const std::string chars = alphabet;
+  for (size_t size : {0, 1, 7, 100, 1000, 20000})
+  {
+    for (size_t segment_count : {1, 2, 8, 33})
+    {
+      std::string str;
+      for (size_t i = 0; i < size; ++i)
+        str += chars[rng() % chars.size()];
+      if (neam::ct::alphyn::internal::find_split_points<SplitSyntax>(str.c_str(), str.size(), segment_count, thread_count) != naive_split_points<SplitSyntax>(str, segment_count))
+        return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Return the values of the records of \p str (-1000 for a failed record), and set \p failed to has_failed()
+inline std::vector<long> record_values(const char *str, bool &failed)
+{
+  std::vector<long> values;
+  auto records = statement_math_eval::parser::parse_records<long>(str);
+  for (const auto &result : records)
+    values.push_back(result.has_value() ? result.get_value() : -1000);
+  failed = records.has_failed();
+  return values;
+}
+
+/// \brief parse_prefix, parse_records and parse_file_parallel
+inline void test_records()
+{
+  using stmt_parser = statement_math_eval::parser;
+
+  // parse_prefix, at compile-time
+  static_assert(compile_time_prefix("1 + 1; 2 * 3;", 0) == 2 && compile_time_prefix("1 + 1; 2 * 3;", 6) == 6, "parse_prefix works at compile-time");
+  static_assert(compile_time_prefix("1 + 1; 2 * 3;", 0, true) == 6 && compile_time_prefix("1 + 1; 2 * 3;", 6, true) == 13, "parse_prefix works at compile-time");
+
+  // parse_prefix: the first sentence only, and where it ends
+  {
+    size_t end_index = 0;
+    const auto first = stmt_parser::parse_prefix<long>("1 + 1; 2 * 3;", 0, end_index);
+    ALPHYN_CHECK(first.has_value() && first.get_value() == 2 && end_index == 6);
+    const auto second = stmt_parser::parse_prefix<long>("1 + 1; 2 * 3;", end_index, end_index);
+    ALPHYN_CHECK(second.has_value() && second.get_value() == 6 && end_index == 13);
+
+    // what follows the sentence is not looked at (even if it isn't valid)
+    ALPHYN_CHECK(stmt_parser::parse_prefix<long>("(4 - 2) * 5 ; ) # garbage", 0, end_index).get_value() == 10 && end_index == 13);
+
+    // an error: end_index is the index of the token that caused it
+    const auto error = stmt_parser::parse_prefix<long>("1 + 1; 2 * * 3;", 6, end_index);
+    ALPHYN_CHECK(!error.has_value() && error.get_error().offset == 11 && end_index == 11);
+    // no ';'
+    ALPHYN_CHECK(!stmt_parser::parse_prefix<long>("1 + 1", 0, end_index).has_value() && end_index == 5);
+
+    // with a context
+    stmt_parser::context ctx;
+    ALPHYN_CHECK(stmt_parser::parse_prefix<long>(ctx, "8 / 2; 1;", 0, end_index).get_value() == 4 && end_index == 6);
+    ALPHYN_CHECK(stmt_parser::parse_prefix<long>(ctx, "8 / 2; 1;", end_index, end_index).get_value() == 1 && end_index == 9);
+  }
+
+  // parse_records
+  {
+    bool failed = true;
+    ALPHYN_CHECK(record_values("1 + 1; 2*3;(4 - 2) * 5 ;\n 7;  ", failed) == std::vector<long>({2, 6, 10, 7}));
+    ALPHYN_CHECK(!failed);
+    ALPHYN_CHECK(record_values("", failed).empty() && !failed);
+    ALPHYN_CHECK(record_values("  \n ", failed).empty() && !failed);
+
+    // the start and end indexes of the records
+    auto records = stmt_parser::parse_records<long>("1 + 1; 2*3;  4;", 6);
+    std::vector<size_t> indexes;
+    for (const auto &result : records)
+    {
+      ALPHYN_CHECK(result.has_value());
+      indexes.push_back(records.get_record_start_index());
+      indexes.push_back(records.get_record_end_index());
+    }
+    ALPHYN_CHECK(indexes == std::vector<size_t>({6, 11, 11, 15})); // the first record starts at the start index
+  }
+
+  // a failed record: it is the last one, its result is the error, and has_failed() is set
+  {
+    auto records = stmt_parser::parse_records<long>("1; 2 + ; 3;");
+    std::vector<neam::ct::alphyn::parse_result<long, math_eval::type_t>> results;
+    for (const auto &result : records)
+      results.push_back(result);
+    ALPHYN_CHECK(records.has_failed());
+    ALPHYN_CHECK(results.size() == 2);
+    ALPHYN_CHECK(results.size() == 2 && results[0].has_value() && results[0].get_value() == 1);
+    ALPHYN_CHECK(results.size() == 2 && !results[1].has_value() && results[1].get_error().offset == 7);
+
+    // begin() again doesn't restart the iteration
+    auto it = records.begin();
+    ALPHYN_CHECK(it == records.end());
+
+    bool failed = false;
+    ALPHYN_CHECK(record_values("1; 2; 3", failed) == std::vector<long>({1, 2, -1000}) && failed);
+  }
+
+  // the split points of parse_file_parallel (with and without strings and comments, on one and four threads)
+  {
+    using neam::ct::alphyn::split_syntax;
+    ALPHYN_CHECK(split_points_match_naive<split_syntax<';'>>("ab; \n", 1));
+    ALPHYN_CHECK(split_points_match_naive<split_syntax<';'>>("ab; \n", 4));
+    ALPHYN_CHECK(split_points_match_naive<split_syntax<';', '"', '\\', '#'>>("aaab;;\"\\#\n ", 1));
+    ALPHYN_CHECK(split_points_match_naive<split_syntax<';', '"', '\\', '#'>>("aaab;;\"\\#\n ", 4));
+    ALPHYN_CHECK(split_points_match_naive<split_syntax<'\n', '\'', '\'', '#'>>("aab;'#\n\n ", 4)); // '' in a string, '\n' as separator
+    ALPHYN_CHECK(split_points_match_naive<split_syntax<';', '\0', '\\', '#'>>("ab;#\n ", 4));    // only comments
+
+    // a long string, over several targets
+    const std::string str = "1; \"" + std::string(1000, ';') + "\"; 2; 3;";
+    const std::vector<size_t> points = neam::ct::alphyn::internal::find_split_points<split_syntax<';', '"'>>(str.c_str(), str.size(), 8, 4);
+    ALPHYN_CHECK(points == std::vector<size_t>({0, str.size() - 6, str.size()})); // the targets are all in the string
+  }
+
+  // parse_file_parallel
+  {
+    using splitter = neam::ct::alphyn::split_syntax<';', '"', '\\', '#'>;
+    auto add = [](long a, long b) { return a + b; };
+
+    std::string input;
+    long expected = 0;
+    for (long i = 0; i < 3000; ++i)
+    {
+      input += std::to_string(i) + " * 2 + (1 - 1);" + (i % 7 ? " " : "\n");
+      expected += i * 2;
+    }
+
+    for (size_t thread_count : {1, 4})
+    {
+      long sum = -1;
+      ALPHYN_CHECK(stmt_parser::parse_file_parallel<long, splitter>(input.c_str(), input.size(), sum, add, thread_count).empty());
+      ALPHYN_CHECK(sum == expected);
+      ALPHYN_CHECK(stmt_parser::parse_file_parallel<long, neam::ct::alphyn::split_syntax<';'>>(input.c_str(), input.size(), sum, add, thread_count).empty());
+      ALPHYN_CHECK(sum == expected);
+    }
+
+    // white space at the end (and at the start), and an empty input
+    {
+      const std::string spaced = "  \n" + input + "  \n \n  ";
+      long sum = -1;
+      ALPHYN_CHECK(stmt_parser::parse_file_parallel<long, splitter>(spaced.c_str(), spaced.size(), sum, add, 4).empty() && sum == expected);
+      ALPHYN_CHECK(stmt_parser::parse_file_parallel<long, splitter>("", 0, sum, add, 4).empty() && sum == 0);
+      ALPHYN_CHECK(stmt_parser::parse_file_parallel<long, splitter>("  \n ", 4, sum, add, 4).empty() && sum == 0);
+    }
+
+    // an error in a segment (in the middle of the input): reported once, at its offset, and the other segments are parsed
+    {
+      std::string with_error = input;
+      const size_t error_record = with_error.find("1500 * 2");
+      with_error.replace(error_record, 8, "1500 * *");
+      long sum = -1;
+      const std::vector<neam::ct::alphyn::batch_error> errors = stmt_parser::parse_file_parallel<long, splitter>(with_error.c_str(), with_error.size(), sum, add, 4);
+      ALPHYN_CHECK(errors.size() == 1);
+      ALPHYN_CHECK(errors.size() == 1 && errors[0].offset == error_record + 7 && errors[0].index > 0 && errors[0].index < 31);
+
+      // an error in the last record (no ';')
+      with_error = input + " 1 + 1";
+      const std::vector<neam::ct::alphyn::batch_error> last_errors = stmt_parser::parse_file_parallel<long, splitter>(with_error.c_str(), with_error.size(), sum, add, 4);
+      ALPHYN_CHECK(last_errors.size() == 1 && last_errors[0].offset == with_error.size());
+    }
+  }
+}
+
+#endif /*__N_2309827114563218_1193054471290__TEST_RECORDS_HPP__*/
@@ -0,0 +1,149 @@
+//
+// file : test_recovery.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_3091278341206613_2274516010933__TEST_RECOVERY_HPP__
+# define __N_3091278341206613_2274516010933__TEST_RECOVERY_HPP__
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "test_errors.hpp"
+#include "check.hpp"
+
+/// \brief parse_string_with_recovery with the parser \p Parser (of recovering_math_eval)
+template<typename Parser>
+void check_recovery()
+{
+  using error_list = std::vector<neam::ct::alphyn::parse_error<math_eval::type_t>>;
+
+  // valid statements: no errors
+  {
+    error_list errors;
+    const auto result = Parser::template parse_string_with_recovery<std::vector<long>>("1; 2 * 3; (4 - 1);", errors);
+    ALPHYN_CHECK(result.has_value() && result.get_value() == std::vector<long>({1, 6, 3}));
+    ALPHYN_CHECK(errors.empty());
+  }
+
+  // two invalid statements, and a valid one
+  {
+    error_list errors;
+    const auto result = Parser::template parse_string_with_recovery<std::vector<long>>("1+; 2 2; 3*3;", errors);
+    ALPHYN_CHECK(result.has_value() && result.get_value() == std::vector<long>({-1000, -1000, 9}));
+    ALPHYN_CHECK(errors.size() == 2);
+    ALPHYN_CHECK(errors.size() == 2 && errors[0].offset == 2 && errors[0].token_type == statement_math_eval::tok_semicolon);
+    ALPHYN_CHECK(errors.size() == 2 && errors[1].offset == 6 && errors[1].token_type == math_eval::tok_number);
+
+    // with a context, and invalid tokens (skipped one character at a time)
+    typename Parser::context ctx;
+    error_list ctx_errors;
+    const auto ctx_result = Parser::template parse_string_with_recovery<std::vector<long>>(ctx, "5; 1 # # 2; ;; 7;", ctx_errors);
+    ALPHYN_CHECK(ctx_result.has_value() && ctx_result.get_value() == std::vector<long>({5, -1000, -1000, -1000, 7}));
+    ALPHYN_CHECK(ctx_errors.size() == 3 && ctx_errors[0].offset == 5 && ctx_errors[1].offset == 12 && ctx_errors[2].offset == 13);
+  }
+
+  // unrecoverable: the end of the input is reached while discarding
+  {
+    error_list errors;
+    const auto result = Parser::template parse_string_with_recovery<std::vector<long>>("1; 2 +", errors);
+    ALPHYN_CHECK(!result.has_value());
+    ALPHYN_CHECK(errors.size() == 1 && errors[0].offset == 6 && errors[0].token_type == math_eval::tok_end);
+    ALPHYN_CHECK(result.get_error().offset == 6);
+  }
+
+  // random inputs: the parse always ends, and the errors are recorded in order, once each
+  {
+    std::mt19937 rng(1234);
+    const std::string chars = "12+*();;  #";
+    bool errors_in_order = true;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+      std::string input;
+      const size_t size = rng() % 24;
+      for (size_t j = 0; j < size; ++j)
+        input += chars[rng() % chars.size()];
+      error_list errors;
+      const auto result = Parser::template parse_string_with_recovery<std::vector<long>>(input.c_str(), errors);
+      for (size_t j = 1; j < errors.size(); ++j)
+        errors_in_order = errors_in_order && errors[j - 1].offset < errors[j].offset;
+      errors_in_order = errors_in_order && (result.has_value() || !errors.empty() || input.find_first_not_of(' ') == std::string::npos);
+    }
+    ALPHYN_CHECK(errors_in_order);
+  }
+}
+
+/// \brief Error recovery (parse_string_with_recovery and iterative_parser::recover)
+inline void test_recovery()
+{
+  using rec_parser = recovering_math_eval::parser;
+  check_recovery<rec_parser>();
+  check_recovery<neam::ct::alphyn::parser<recovering_math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::lalr1>>();
+  check_recovery<neam::ct::alphyn::parser<recovering_math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::bypass_unit_rules>>();
+  check_recovery<neam::ct::alphyn::parser<recovering_math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::bypass_unit_rules, neam::ct::alphyn::lalr1>>();
+
+  // iterative_parser::recover, directly
+  using iterative = neam::ct::alphyn::internal::iterative_parser<recovering_math_eval, rec_parser>;
+  const auto run = [](const char *str, bool skip_current, size_t &recovery_count) -> std::vector<long>
+  {
+    rec_parser::uts_t stack = rec_parser::uts_t();
+    neam::ct::alphyn::lexem_list<recovering_math_eval> ll = recovering_math_eval::lexer::get_lazy_lexer(str);
+    iterative::position pos;
+    recovery_count = 0;
+    while (true)
+    {
+      while (iterative::advance(stack, ll, pos));
+      if (stack.size() == 1 && stack.get_top_type() == recovering_math_eval::start)
+        return stack.get<std::vector<long>>();
+      // the first recovery may skip the rejected token (as after a recovery that has consumed nothing)
+      if (!iterative::recover(stack, ll, pos, str, skip_current && !recovery_count))
+        return std::vector<long>();
+      ++recovery_count;
+    }
+  };
+  size_t recovery_count = 0;
+  ALPHYN_CHECK(run("1+; 2; 3;", false, recovery_count) == std::vector<long>({-1000, 2, 3}) && recovery_count == 1);
+  // skip_current (used when the previous recovery hasn't consumed anything, so that the parse always ends) discards the rejected token first:
+  // the ';' after "1+" is dropped, and the error token goes up to the next ';'
+  ALPHYN_CHECK(run("1+; 2; 3;", true, recovery_count) == std::vector<long>({-1000, 3}) && recovery_count == 1);
+  // no state can shift the error token (the stack is emptied)
+  using no_error_rule_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+  using no_error_rule_iterative = neam::ct::alphyn::internal::iterative_parser<math_eval, no_error_rule_parser>;
+  {
+    const char *str = "1 + + 2";
+    no_error_rule_parser::uts_t stack = no_error_rule_parser::uts_t();
+    neam::ct::alphyn::lexem_list<math_eval> ll = math_eval::lexer::get_lazy_lexer(str);
+    no_error_rule_iterative::position pos;
+    while (no_error_rule_iterative::advance(stack, ll, pos));
+    ALPHYN_CHECK(ll.get_token().start_index == 4);
+    ALPHYN_CHECK(!no_error_rule_iterative::recover(stack, ll, pos, str, false));
+
+    std::vector<neam::ct::alphyn::parse_error<math_eval::type_t>> errors;
+    ALPHYN_CHECK(!no_error_rule_parser::parse_string_with_recovery<long>(str, errors).has_value() && errors.size() == 1 && errors[0].offset == 4);
+  }
+}
+
+#endif /*__N_3091278341206613_2274516010933__TEST_RECOVERY_HPP__*/
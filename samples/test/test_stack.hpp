@@ -0,0 +1,134 @@
+//
+// file : test_stack.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_6838700753038848704_3898514120__TEST_STACK_HPP__
+# define __N_6838700753038848704_3898514120__TEST_STACK_HPP__
+
+#include <string>
+#include <memory>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief What a counting_allocator counts
+struct allocation_counters
+{
+  size_t allocation_count = 0;
+  size_t allocated_bytes = 0;
+  size_t live_bytes = 0;
+};
+
+/// \brief A stateful allocator: it counts what it allocates in the counters it has been given
+template<typename T>
+struct counting_allocator
+{
+  using value_type = T;
+  using counters = allocation_counters;
+
+  explicit counting_allocator(counters &_counts) : counts(&_counts) {}
+  template<typename U>
+  counting_allocator(const counting_allocator<U> &o) : counts(o.counts) {}
+
+  T *allocate(size_t count)
+  {
+    ++counts->allocation_count;
+    counts->allocated_bytes += count * sizeof(T);
+    counts->live_bytes += count * sizeof(T);
+    return std::allocator<T>().allocate(count);
+  }
+  void deallocate(T *ptr, size_t count)
+  {
+    counts->live_bytes -= count * sizeof(T);
+    std::allocator<T>().deallocate(ptr, count);
+  }
+
+  template<typename U>
+  bool operator == (const counting_allocator<U> &o) const { return counts == o.counts; }
+  template<typename U>
+  bool operator != (const counting_allocator<U> &o) const { return counts != o.counts; }
+
+  counters *counts;
+};
+
+/// \brief The stack policies: bound checking, growth, and the allocator instance of growable_stack
+inline void test_stack()
+{
+  using neam::ct::alphyn::on_parse_error;
+
+  // checked_stack: the parse fails, with parse_error::stack_overflow, when the input is deeper than the capacity
+  {
+    using checked_parser = neam::ct::alphyn::parser<math_eval, on_parse_error::return_result, neam::ct::alphyn::checked_stack<8>>;
+    static_assert(checked_parser::parse_string<long>("((1 + 2))").get_value() == 3, "a checked_stack works at compile-time");
+    static_assert(checked_parser::parse_string<long>("((((((((1))))))))").get_error().stack_overflow, "and so does its overflow");
+
+    ALPHYN_CHECK(checked_parser::parse_string<long>("(((1)))").get_value() == 1);
+    const auto result = checked_parser::parse_string<long>("1 + (((((((2)))))))");
+    ALPHYN_CHECK(!result);
+    ALPHYN_CHECK(result.get_error().stack_overflow);
+    ALPHYN_CHECK(result.get_error().offset == 10); // the 7th '(' would be the 9th symbol of the stack
+    const auto syntax_error = checked_parser::parse_string<long>("1 + + 2");
+    ALPHYN_CHECK(!syntax_error && !syntax_error.get_error().stack_overflow);
+
+    checked_parser::context ctx;
+    ALPHYN_CHECK(!checked_parser::parse_string<long>(ctx, "((((((((((1))))))))))").has_value());
+    ALPHYN_CHECK(checked_parser::parse_string<long>(ctx, "((1))").get_value() == 1); // the overflow is reset with the context
+  }
+
+  // growable_stack: much deeper than the automaton has states
+  {
+    using growable_parser = neam::ct::alphyn::parser<math_eval, on_parse_error::return_result, neam::ct::alphyn::growable_stack<std::allocator<char>, 4>>;
+    const size_t depth = 2000;
+    const std::string str = std::string(depth, '(') + "1 + 2" + std::string(depth, ')') + " * 3";
+    ALPHYN_CHECK(growable_parser::parse_string<long>(str.c_str()).get_value() == 9);
+    growable_parser::context ctx;
+    ALPHYN_CHECK(growable_parser::parse_string<long>(ctx, str.c_str()).get_value() == 9);
+    ALPHYN_CHECK(ctx.get_stack().capacity() >= depth);
+    ALPHYN_CHECK(growable_parser::parse_string<long>(ctx, (std::string(depth, '(') + "1").c_str()).has_value() == false);
+  }
+
+  // growable_stack with an allocator instance: every array of the stack uses it
+  {
+    using alloc_t = counting_allocator<char>;
+    using alloc_parser = neam::ct::alphyn::parser<math_eval, on_parse_error::return_result, neam::ct::alphyn::growable_stack<alloc_t, 4>>;
+    allocation_counters counts;
+    {
+      alloc_parser::context ctx{alloc_t(counts)};
+      ALPHYN_CHECK(counts.allocation_count == 3); // the values, the states and the types
+      const size_t initial_bytes = counts.allocated_bytes;
+
+      ALPHYN_CHECK(alloc_parser::parse_string<long>(ctx, "1 + 2").get_value() == 3);
+      ALPHYN_CHECK(counts.allocation_count == 3);
+
+      const std::string str = std::string(500, '(') + "4" + std::string(500, ')');
+      ALPHYN_CHECK(alloc_parser::parse_string<long>(ctx, str.c_str()).get_value() == 4);
+      ALPHYN_CHECK(counts.allocation_count > 3 && counts.allocated_bytes > initial_bytes);
+      ALPHYN_CHECK(ctx.get_stack().capacity() >= 500);
+    }
+    ALPHYN_CHECK(counts.live_bytes == 0);
+  }
+}
+
+#endif /*__N_6838700753038848704_3898514120__TEST_STACK_HPP__*/
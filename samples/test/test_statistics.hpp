@@ -0,0 +1,143 @@
+//
+// file : test_statistics.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_3990635562586744949_2543546368__TEST_STATISTICS_HPP__
+# define __N_3990635562586744949_2543546368__TEST_STATISTICS_HPP__
+
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief The sum of the counts of \p counts
+inline size_t statistics_sum(const std::vector<size_t> &counts)
+{
+  return std::accumulate(counts.begin(), counts.end(), size_t(0));
+}
+
+/// \brief The collect_statistics policy
+inline void test_statistics()
+{
+  using stats_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::collect_statistics>;
+  using tools = neam::ct::alphyn::grammar_tools<math_eval>;
+
+  // no statistics, no storage
+  using value_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+  static_assert(sizeof(value_parser::uts_t) < sizeof(stats_parser::uts_t), "the stack of a parser without statistics has no statistics pointer");
+  static_assert(sizeof(stats_parser::context) - sizeof(value_parser::context) >= sizeof(neam::ct::alphyn::parser_statistics),
+                "the context of a parser without statistics has no parser_statistics");
+
+  stats_parser::context ctx;
+
+  // "1 + 2": 4 tokens (and the one read after tok_end), and 7 reductions: val (x2), prod (x2), sum -> prod, sum -> sum + prod, start -> sum
+  {
+    ALPHYN_CHECK(stats_parser::parse_string<long>(ctx, "1 + 2").get_value() == 3);
+    const neam::ct::alphyn::parse_statistics &last = ctx.get_statistics().last;
+    ALPHYN_CHECK(last.parse_count == 1);
+    ALPHYN_CHECK(last.token_count == 5);
+    ALPHYN_CHECK(last.shift_count == 4);
+    ALPHYN_CHECK(last.reduction_count == 7);
+    ALPHYN_CHECK(last.max_stack_depth == 3); // sum + 2
+    ALPHYN_CHECK(last.reductions.size() == 9 && last.state_visits.size() == stats_parser::state_count);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::start>::value] == 1);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::sum, 0>::value] == 1);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::sum, 1>::value] == 1);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::prod, 0>::value] == 2);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::val, 0>::value] == 2);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::prod, 1>::value] == 0);
+    ALPHYN_CHECK(statistics_sum(last.reductions) == last.reduction_count);
+    // each shift and each reduction (but the last one: it accepts) takes an edge, and each edge enters a state (plus the initial state)
+    ALPHYN_CHECK(statistics_sum(last.edge_visits) == last.shift_count + last.reduction_count - 1);
+    ALPHYN_CHECK(statistics_sum(last.state_visits) == statistics_sum(last.edge_visits) + 1);
+    ALPHYN_CHECK(last.state_visits[0] == 1);
+    ALPHYN_CHECK(last.lexing_time >= 0 && last.parsing_time >= 0);
+  }
+
+  // "((1))": deeper
+  {
+    ALPHYN_CHECK(stats_parser::parse_string<long>(ctx, "((1))").get_value() == 1);
+    const neam::ct::alphyn::parse_statistics &last = ctx.get_statistics().last;
+    ALPHYN_CHECK(last.shift_count == 6 && last.reduction_count == 10 && last.max_stack_depth == 4);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::val, 1>::value] == 2);
+    ALPHYN_CHECK(last.reductions[tools::rule_id<math_eval::sum, 0>::value] == 3);
+  }
+
+  // a syntax error: everything up to the error is counted (no goto for the failed token)
+  {
+    ALPHYN_CHECK(!stats_parser::parse_string<long>(ctx, "1 + + 2"));
+    const neam::ct::alphyn::parse_statistics &last = ctx.get_statistics().last;
+    ALPHYN_CHECK(last.token_count == 3 && last.shift_count == 2 && last.reduction_count == 3);
+    ALPHYN_CHECK(statistics_sum(last.edge_visits) == last.shift_count + last.reduction_count);
+  }
+
+  // total: every parse since the creation of the context (or clear_statistics())
+  {
+    const neam::ct::alphyn::parse_statistics &total = ctx.get_statistics().total;
+    ALPHYN_CHECK(total.parse_count == 3);
+    ALPHYN_CHECK(total.shift_count == 4 + 6 + 2);
+    ALPHYN_CHECK(total.reduction_count == 7 + 10 + 3);
+    ALPHYN_CHECK(total.max_stack_depth == 4);
+    ALPHYN_CHECK(total.reductions[tools::rule_id<math_eval::val, 0>::value] == 2 + 1 + 1);
+
+    // parses without a context record nothing
+    stats_parser::parse_string<long>("1 + 2");
+    ALPHYN_CHECK(ctx.get_statistics().total.parse_count == 3);
+
+    ctx.clear_statistics();
+    ALPHYN_CHECK(total.parse_count == 0 && total.shift_count == 0 && statistics_sum(total.reductions) == 0 && statistics_sum(total.edge_visits) == 0);
+    ALPHYN_CHECK(stats_parser::parse_string<long>(ctx, "1 + 2"));
+    ALPHYN_CHECK(total.parse_count == 1 && total.shift_count == 4 && total.reduction_count == 7);
+  }
+
+  // the same counts with error recovery (when there's no error), and fewer reductions with bypass_unit_rules
+  {
+    std::vector<neam::ct::alphyn::parse_error<math_eval::type_t>> errors;
+    const char *str = "1 + 2 * (3 - 4) * 5";
+    ALPHYN_CHECK(stats_parser::parse_string<long>(ctx, str).get_value() == -9);
+    const neam::ct::alphyn::parse_statistics first = ctx.get_statistics().last;
+    ALPHYN_CHECK(stats_parser::parse_string_with_recovery<long>(ctx, str, errors).get_value() == -9);
+    const neam::ct::alphyn::parse_statistics &second = ctx.get_statistics().last;
+    ALPHYN_CHECK(first.token_count == second.token_count && first.shift_count == second.shift_count && first.reductions == second.reductions);
+    ALPHYN_CHECK(first.state_visits == second.state_visits && first.edge_visits == second.edge_visits);
+
+    using bypass_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::collect_statistics,
+                                                   neam::ct::alphyn::bypass_unit_rules>;
+    bypass_parser::context bypass_ctx;
+    ALPHYN_CHECK(bypass_parser::parse_string<long>(bypass_ctx, str).get_value() == -9);
+    const neam::ct::alphyn::parse_statistics &bypassed = bypass_ctx.get_statistics().last;
+    ALPHYN_CHECK(bypassed.shift_count == first.shift_count);
+    ALPHYN_CHECK(bypassed.reductions[tools::rule_id<math_eval::prod, 0>::value] == 0);
+    ALPHYN_CHECK(bypassed.reduction_count == first.reduction_count - first.reductions[tools::rule_id<math_eval::prod, 0>::value]);
+
+    std::ostringstream os;
+    stats_parser::print_statistics(os, first);
+    ALPHYN_CHECK(os.str().find("[prod]") != std::string::npos);
+  }
+}
+
+#endif /*__N_3990635562586744949_2543546368__TEST_STATISTICS_HPP__*/
@@ -0,0 +1,146 @@
+//
+// file : test_syntax_tree.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_5971679754087640246_3693916246__TEST_SYNTAX_TREE_HPP__
+# define __N_5971679754087640246_3693916246__TEST_SYNTAX_TREE_HPP__
+
+#include <string>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief Write the tree under \p index as (type child...), tokens being their text
+inline std::string syntax_tree_to_string(const neam::ct::alphyn::syntax_tree<math_eval> &tree, const char *str, uint32_t index)
+{
+  const auto &n = tree[index];
+  if (n.is_token())
+    return n.type == math_eval::tok_end ? "$" : std::string(str + n.start_index, str + n.end_index);
+  std::string ret = "(" + math_eval::get_name_for_token_type(n.type);
+  for (uint32_t i = 0; i < n.child_count; ++i)
+    ret += " " + syntax_tree_to_string(tree, str, tree.get_child_index(n, i));
+  return ret + ")";
+}
+
+/// \brief Check what holds for every tree: post-order, contiguous child ranges and node ranges that cover the children
+inline bool syntax_tree_is_valid(const neam::ct::alphyn::syntax_tree<math_eval> &tree)
+{
+  using tree_t = neam::ct::alphyn::syntax_tree<math_eval>;
+  size_t child_sum = 0;
+  for (uint32_t i = 0; i < tree.size(); ++i)
+  {
+    const auto &n = tree[i];
+    if (n.is_token() != (n.child_count == 0) || n.first_child != child_sum || n.start_index > n.end_index)
+      return false;
+    for (uint32_t j = 0; j < n.child_count; ++j)
+    {
+      const tree_t::index_t child = tree.get_child_index(n, j);
+      if (child >= i || (j > 0 && child <= tree.get_child_index(n, j - 1)))
+        return false;
+    }
+    if (!n.is_token() && (n.start_index != tree.get_child(n, 0).start_index || n.end_index != tree.get_child(n, n.child_count - 1).end_index))
+      return false;
+    child_sum += n.child_count;
+  }
+  return child_sum == tree.get_children().size() && child_sum + 1 == tree.size();
+}
+
+/// \brief The build_syntax_tree policy
+inline void test_syntax_tree()
+{
+  using tree_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::build_syntax_tree>;
+  using tools = neam::ct::alphyn::grammar_tools<math_eval>;
+  using tree_t = neam::ct::alphyn::syntax_tree<math_eval>;
+
+  // the rule ids count the rules of every production rule set, in order
+  static_assert(tools::rule_id<math_eval::start>::value == 0, "the first rule has the id 0");
+  static_assert(tools::rule_id<math_eval::sum, 2>::value == 3, "start has one rule, so sum -> sum - prod is the rule 3");
+  static_assert(tools::rule_id<math_eval::val, 1>::value == 8, "val -> ( sum ) is the last rule");
+
+  tree_t tree;
+  {
+    const char *str = "1 + 2 * 3";
+    ALPHYN_CHECK(tree_parser::build_tree(tree, str));
+    ALPHYN_CHECK(syntax_tree_is_valid(tree));
+    ALPHYN_CHECK(syntax_tree_to_string(tree, str, tree.get_root_index())
+                 == "([start] ([sum] ([sum] ([prod] ([val] 1))) + ([prod] ([prod] ([val] 2)) * ([val] 3))) $)");
+
+    // the exact layout: the leaves are added as they are shifted, the nodes as they are reduced
+    ALPHYN_CHECK(tree.size() == 15);
+    ALPHYN_CHECK(tree.get_root_index() == 14);
+    ALPHYN_CHECK(tree[0].is_token() && tree[0].type == math_eval::tok_number && tree[0].start_index == 0 && tree[0].end_index == 1);
+    ALPHYN_CHECK(tree[1].type == math_eval::val && tree[1].rule == tools::rule_id<math_eval::val, 0>::value && tree.get_child_index(tree[1], 0) == 0);
+    ALPHYN_CHECK(tree[3].type == math_eval::sum && tree[3].rule == tools::rule_id<math_eval::sum, 0>::value);
+    ALPHYN_CHECK(tree[4].is_token() && tree[4].type == math_eval::tok_add && tree[4].start_index == 2 && tree[4].end_index == 3);
+    ALPHYN_CHECK(tree[11].type == math_eval::prod && tree[11].rule == tools::rule_id<math_eval::prod, 1>::value);
+    ALPHYN_CHECK(tree[11].start_index == 4 && tree[11].end_index == 9 && tree[11].child_count == 3);
+    ALPHYN_CHECK(tree.get_child_index(tree[11], 0) == 7 && tree.get_child_index(tree[11], 1) == 8 && tree.get_child_index(tree[11], 2) == 10);
+    ALPHYN_CHECK(tree[12].type == math_eval::sum && tree[12].rule == tools::rule_id<math_eval::sum, 1>::value);
+    ALPHYN_CHECK(tree[12].first_child == 9 && tree[12].child_count == 3);
+    ALPHYN_CHECK(tree[13].is_token() && tree[13].type == math_eval::tok_end && tree[13].start_index == 9 && tree[13].end_index == 9);
+    ALPHYN_CHECK(tree.get_root().type == math_eval::start && tree.get_root().rule == tools::rule_id<math_eval::start>::value);
+    ALPHYN_CHECK(tree.get_root().start_index == 0 && tree.get_root().end_index == 9);
+    ALPHYN_CHECK(tree.get_children().size() == 14);
+  }
+
+  // the tree is cleared before each parse
+  {
+    const char *str = "(4)";
+    ALPHYN_CHECK(tree_parser::build_tree(tree, str));
+    ALPHYN_CHECK(syntax_tree_is_valid(tree));
+    ALPHYN_CHECK(syntax_tree_to_string(tree, str, tree.get_root_index()) == "([start] ([sum] ([prod] ([val] ( ([sum] ([prod] ([val] 4))) )))) $)");
+    ALPHYN_CHECK(tree.get_root().rule == 0 && tree[tree.size() - 5].rule == tools::rule_id<math_eval::val, 1>::value);
+  }
+
+  // with a context, and with the unit rules bypassed (prod -> val, that has a state of its own, has no nodes. sum -> prod has to
+  // look at the next token for a '*', so it isn't bypassed)
+  {
+    using bypass_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::build_syntax_tree,
+                                                   neam::ct::alphyn::bypass_unit_rules>;
+    bypass_parser::context ctx;
+    const char *str = "1 + 2 * 3 - (4 / 5)";
+    ALPHYN_CHECK(bypass_parser::build_tree(ctx, tree, str));
+    ALPHYN_CHECK(syntax_tree_is_valid(tree));
+    for (const auto &n : tree)
+      ALPHYN_CHECK(n.rule != tools::rule_id<math_eval::prod, 0>::value);
+
+    tree_parser::context tree_ctx;
+    tree_t full_tree;
+    ALPHYN_CHECK(tree_parser::build_tree(tree_ctx, full_tree, str));
+    ALPHYN_CHECK(syntax_tree_is_valid(full_tree));
+    ALPHYN_CHECK(full_tree.size() > tree.size());
+    ALPHYN_CHECK(full_tree.get_root().end_index == tree.get_root().end_index);
+  }
+
+  // errors
+  {
+    const auto result = tree_parser::build_tree(tree, "1 + * 2");
+    ALPHYN_CHECK(!result);
+    ALPHYN_CHECK(result.get_error().offset == 4);
+    ALPHYN_CHECK(result.get_error().token_type == math_eval::tok_mul);
+  }
+}
+
+#endif /*__N_5971679754087640246_3693916246__TEST_SYNTAX_TREE_HPP__*/
@@ -0,0 +1,144 @@
+//
+// file : test_trace.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2717833299945579601_2698588507__TEST_TRACE_HPP__
+# define __N_2717833299945579601_2698588507__TEST_TRACE_HPP__
+
+#include <sstream>
+#include <string>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief Return true if \p a and \p b are the same event
+inline bool same_trace_event(const neam::ct::alphyn::trace_event &a, const neam::ct::alphyn::trace_event &b)
+{
+  return a.kind == b.kind && a.state == b.state && a.target == b.target && a.symbol == b.symbol && a.value == b.value;
+}
+
+/// \brief The tracer policies, and the trace_buffer ring buffer
+inline void test_trace()
+{
+  using neam::ct::alphyn::trace_buffer;
+  using neam::ct::alphyn::trace_event;
+  using neam::ct::alphyn::trace_event_kind;
+
+  // the ring buffer itself: it keeps the last capacity() events, the oldest first
+  {
+    trace_buffer buffer(4);
+    ALPHYN_CHECK(buffer.capacity() == 4 && buffer.size() == 0 && buffer.get_event_count() == 0);
+    for (uint64_t i = 0; i < 3; ++i)
+      buffer.push(trace_event {trace_event_kind::shift, uint32_t(i), uint32_t(-1), 0, i});
+    ALPHYN_CHECK(buffer.size() == 3 && buffer[0].value == 0 && buffer[2].value == 2);
+    for (uint64_t i = 3; i < 11; ++i)
+      buffer.push(trace_event {trace_event_kind::shift, uint32_t(i), uint32_t(-1), 0, i});
+    ALPHYN_CHECK(buffer.size() == 4 && buffer.get_event_count() == 11);
+    ALPHYN_CHECK(buffer[0].value == 7 && buffer[1].value == 8 && buffer[2].value == 9 && buffer[3].value == 10);
+    buffer.clear();
+    ALPHYN_CHECK(buffer.size() == 0 && buffer.get_event_count() == 0);
+    buffer.push(trace_event {trace_event_kind::error, 42, uint32_t(-1), 0, 0});
+    ALPHYN_CHECK(buffer.size() == 1 && buffer[0].state == 42);
+  }
+
+  using small_trace_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::ring_buffer_trace<8>>;
+  using big_trace_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::ring_buffer_trace<1024>>;
+  using tools = neam::ct::alphyn::grammar_tools<math_eval>;
+
+  // no ring buffer, no storage
+  using value_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+  static_assert(sizeof(value_parser::uts_t) < sizeof(small_trace_parser::uts_t), "the stack of a parser without ring buffer has no trace pointer");
+  static_assert(sizeof(small_trace_parser::context) - sizeof(value_parser::context) >= sizeof(trace_buffer),
+                "the context of a parser without ring buffer has no trace_buffer");
+
+  // the parser wraps around: the small buffer has the last 8 events of the big one
+  {
+    small_trace_parser::context small_ctx;
+    big_trace_parser::context big_ctx;
+    const char *str = "1 + 2 * (3 - 4) / 5";
+    ALPHYN_CHECK(small_trace_parser::parse_string<long>(small_ctx, str).get_value() == 1);
+    ALPHYN_CHECK(big_trace_parser::parse_string<long>(big_ctx, str).get_value() == 1);
+    const trace_buffer &small = small_ctx.get_trace();
+    const trace_buffer &big = big_ctx.get_trace();
+    ALPHYN_CHECK(small.capacity() == 8 && small.size() == 8);
+    ALPHYN_CHECK(big.size() == big.get_event_count() && big.size() > 8 && big.size() < 1024);
+    ALPHYN_CHECK(small.get_event_count() == big.get_event_count());
+    for (size_t i = 0; i < 8; ++i)
+      ALPHYN_CHECK(same_trace_event(small[i], big[big.size() - 8 + i]));
+
+    // the whole parse: it starts by entering the initial state, and ends with the reduction of the start rule
+    ALPHYN_CHECK(big[0].kind == trace_event_kind::enter_state && big[0].state == 0);
+    ALPHYN_CHECK(big[1].kind == trace_event_kind::shift && big[1].symbol == math_eval::tok_number && big[1].value == 0);
+    ALPHYN_CHECK(small[7].kind == trace_event_kind::reduce && small[7].symbol == math_eval::start);
+    ALPHYN_CHECK(small[7].value == tools::rule_id<math_eval::start>::value);
+    size_t shift_count = 0;
+    for (size_t i = 0; i < big.size(); ++i)
+      shift_count += (big[i].kind == trace_event_kind::shift);
+    ALPHYN_CHECK(shift_count == 12);
+
+    std::ostringstream os;
+    small_trace_parser::print_trace(os, small);
+    ALPHYN_CHECK(os.str().find("(" + std::to_string(big.size() - 8) + " older events have been lost)") == 0);
+    ALPHYN_CHECK(os.str().find("reduce [start] -> [sum] tok_end") != std::string::npos);
+
+    // cleared at the start of each parse
+    ALPHYN_CHECK(small_trace_parser::parse_string<long>(small_ctx, "7").get_value() == 7);
+    ALPHYN_CHECK(small_ctx.get_trace().size() == 8 && small_ctx.get_trace().get_event_count() < big.get_event_count());
+    ALPHYN_CHECK(small_trace_parser::parse_string<long>(small_ctx, "(").has_value() == false);
+    ALPHYN_CHECK(small_ctx.get_trace().size() == small_ctx.get_trace().get_event_count());
+  }
+
+  // a failing parse ends with the error, at the offset of the token
+  {
+    small_trace_parser::context ctx;
+    const char *str = "1 + 2 * (3 - 4) / + 5";
+    ALPHYN_CHECK(!small_trace_parser::parse_string<long>(ctx, str));
+    const trace_buffer &trace = ctx.get_trace();
+    ALPHYN_CHECK(trace.size() == 8 && trace.get_event_count() > 8);
+    const trace_event &last = trace[trace.size() - 1];
+    ALPHYN_CHECK(last.kind == trace_event_kind::error && last.symbol == math_eval::tok_add && last.value == 18);
+    ALPHYN_CHECK(trace[trace.size() - 2].kind == trace_event_kind::enter_state && trace[trace.size() - 2].state == last.state);
+    ALPHYN_CHECK(trace[trace.size() - 3].kind == trace_event_kind::shift && trace[trace.size() - 3].symbol == math_eval::tok_div);
+
+    // parses without a context record nothing (and don't touch the trace of the context)
+    small_trace_parser::parse_string<long>("1 + 2");
+    ALPHYN_CHECK(ctx.get_trace()[ctx.get_trace().size() - 1].kind == trace_event_kind::error);
+  }
+
+  // stderr_trace prints every step
+  {
+    using stderr_parser = neam::ct::alphyn::parser<math_eval, neam::ct::alphyn::on_parse_error::return_result, neam::ct::alphyn::stderr_trace>;
+    std::ostringstream os;
+    std::streambuf *const cerr_buffer = std::cerr.rdbuf(os.rdbuf());
+    const long result = stderr_parser::parse_string<long>("1 + 2").get_value();
+    std::cerr.rdbuf(cerr_buffer);
+    ALPHYN_CHECK(result == 3);
+    ALPHYN_CHECK(os.str().find("S0\n  S0 <- tok_number \"1\"\n") == 0);
+    ALPHYN_CHECK(os.str().find("reduce [start] -> [sum] tok_end") != std::string::npos);
+    static_assert(sizeof(stderr_parser::uts_t) == sizeof(value_parser::uts_t), "stderr_trace has no trace pointer");
+  }
+}
+
+#endif /*__N_2717833299945579601_2698588507__TEST_TRACE_HPP__*/
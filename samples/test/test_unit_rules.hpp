@@ -0,0 +1,243 @@
+//
+// file : test_unit_rules.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2551783946120853_1640297531822__TEST_UNIT_RULES_HPP__
+# define __N_2551783946120853_1640297531822__TEST_UNIT_RULES_HPP__
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief math_eval, with two more levels of unit rules (prod -> unary, unary -> power, power -> val), and a unary minus
+struct deep_math_eval : public math_eval
+{
+  static constexpr type_t unary = 105;
+  static constexpr type_t power = 106;
+
+  static constexpr return_type attr_neg(const token_type &, return_type n) { return -n; }
+
+  using lexer = neam::ct::alphyn::lexer<deep_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<deep_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<deep_math_eval, Name, Rules...>;
+
+  using grammar = neam::ct::alphyn::grammar<deep_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, unary>,            // prod -> unary
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, unary>,           // prod -> prod * unary
+      production_rule<ALPHYN_ATTRIBUTE(&attr_div), prod, tok_div, unary>            // prod -> prod / unary
+    >,
+    production_rule_set<unary,
+      production_rule<neam::ct::alphyn::forward_first_attribute, power>,            // unary -> power
+      production_rule<ALPHYN_ATTRIBUTE(&attr_neg), tok_sub, unary>                  // unary -> - unary
+    >,
+    production_rule_set<power,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>               // power -> val
+    >,
+    production_rule_set<val,
+      production_rule<neam::ct::alphyn::value_forward_first_attribute, tok_number>,               // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+};
+
+/// \brief A random math_eval expression (numbers from 1 to 9, and no divisions: its value is always defined)
+inline std::string random_expression(std::mt19937 &rng, size_t depth = 0)
+{
+  const size_t choice = depth > 3 ? 0 : rng() % 4;
+  if (choice == 0)
+    return std::string(1, char('1' + rng() % 9));
+  if (choice == 1)
+    return "(" + random_expression(rng, depth + 1) + ")";
+  const char ops[] = {'+', '-', '*'};
+  return random_expression(rng, depth + 1) + (rng() % 2 ? " " : "") + ops[rng() % 3] + random_expression(rng, depth + 1);
+}
+
+/// \brief A random expression, broken half of the time (a character is removed, replaced or inserted)
+inline std::string random_maybe_broken_expression(std::mt19937 &rng)
+{
+  std::string expr = random_expression(rng);
+  if (rng() % 2)
+    return expr;
+  const char chars[] = {'+', '-', '*', '(', ')', '1', ' ', '#'};
+  const size_t index = rng() % (expr.size() + 1);
+  switch (rng() % 3)
+  {
+    case 0: if (index < expr.size()) expr.erase(index, 1); break;
+    case 1: if (index < expr.size()) expr[index] = chars[rng() % sizeof(chars)]; break;
+    case 2: expr.insert(index, 1, chars[rng() % sizeof(chars)]); break;
+  }
+  return expr;
+}
+
+/// \brief Return true if the parsers \p Parser and \p Reference give the same values, and fail on the same tokens, on \p inputs
+template<typename Parser, typename Reference>
+bool parses_like(const std::vector<std::string> &inputs)
+{
+  for (const std::string &input : inputs)
+  {
+    const auto result = Parser::template parse_string<long>(input.c_str());
+    const auto expected = Reference::template parse_string<long>(input.c_str());
+    if (result.has_value() != expected.has_value())
+      return false;
+    if (result.has_value() && result.get_value() != expected.get_value())
+      return false;
+    if (!result.has_value() && (result.get_error().offset != expected.get_error().offset || result.get_error().token_type != expected.get_error().token_type))
+      return false;
+  }
+  return true;
+}
+
+/// \brief For each state of the automaton of \p Parser, true if the state has a default reduction (see grammar_tools::has_default_reduction)
+template<typename Parser, typename StateList = decltype(neam::ct::alphyn::internal::as_plain_type_list(static_cast<typename Parser::automaton_list *>(nullptr)))>
+struct default_reduction_states;
+template<typename Parser, typename... States>
+struct default_reduction_states<Parser, neam::ct::type_list<States...>>
+{
+  static std::vector<bool> get()
+  {
+    return {neam::ct::alphyn::grammar_tools<typename Parser::syntax_class>::template has_default_reduction<States>::value...};
+  }
+};
+
+/// \brief Return true if, for every input of \p inputs that fails to parse, the state that rejects the token doesn't expect that token
+/// (and doesn't have a default reduction, when the parser uses them)
+template<typename Parser>
+bool rejecting_states_are_right(const std::vector<std::string> &inputs)
+{
+  const std::vector<bool> has_default_reduction = default_reduction_states<Parser>::get();
+  for (const std::string &input : inputs)
+  {
+    const auto result = Parser::template parse_string<long>(input.c_str());
+    if (result.has_value())
+      continue;
+    const size_t state = result.get_error().state;
+    if (state >= Parser::state_count || (Parser::uses_default_reductions && has_default_reduction[state]))
+      return false;
+    if (Parser::get_expected_tokens(state).contains(result.get_error().token_type))
+      return false;
+  }
+  return true;
+}
+
+/// \brief The number of reductions done by \p Parser (that must have the collect_statistics policy) to parse \p str
+template<typename Parser>
+size_t reduction_count(const char *str)
+{
+  typename Parser::context ctx;
+  Parser::template parse_string<long>(ctx, str);
+  return ctx.get_statistics().last.reduction_count;
+}
+
+/// \brief The bypass_unit_rules policy, and the default reductions
+inline void test_unit_rules()
+{
+  using neam::ct::alphyn::parser;
+  using neam::ct::alphyn::on_parse_error;
+  using neam::ct::alphyn::bypass_unit_rules;
+  using neam::ct::alphyn::lalr1;
+  using neam::ct::alphyn::collect_statistics;
+
+  // the same values and the same errors as without the policy
+  {
+    std::mt19937 rng(2016);
+    std::vector<std::string> inputs = {"", "1", "(((1)))", "1 +", "1 2", "()", "(1 + 2", "1 + 2)", "1 # 2", "-1", "--1 * -(2 - 3)"};
+    for (size_t i = 0; i < 2000; ++i)
+      inputs.push_back(random_maybe_broken_expression(rng));
+
+    using keep = parser<math_eval, on_parse_error::return_result>;
+    ALPHYN_CHECK(parses_like<parser<math_eval, on_parse_error::return_result, bypass_unit_rules>, keep>(inputs));
+    ALPHYN_CHECK(parses_like<parser<math_eval, on_parse_error::return_result, bypass_unit_rules, lalr1>, keep>(inputs));
+    ALPHYN_CHECK(parses_like<parser<math_eval, on_parse_error::return_result, lalr1, bypass_unit_rules>, keep>(inputs));
+
+    using deep_keep = parser<deep_math_eval, on_parse_error::return_result>;
+    ALPHYN_CHECK(parses_like<parser<deep_math_eval, on_parse_error::return_result, bypass_unit_rules>, deep_keep>(inputs));
+    ALPHYN_CHECK(parses_like<parser<deep_math_eval, on_parse_error::return_result, bypass_unit_rules, lalr1>, deep_keep>(inputs));
+
+    // the default reductions (the same values and errors as when every reduction checks the next token)
+    using neam::ct::alphyn::no_default_reductions;
+    using checking = parser<math_eval, on_parse_error::return_result, no_default_reductions>;
+    ALPHYN_CHECK(parses_like<keep, checking>(inputs));
+    ALPHYN_CHECK(parses_like<parser<math_eval, on_parse_error::return_result, lalr1>, checking>(inputs));
+    ALPHYN_CHECK(parses_like<parser<math_eval, on_parse_error::return_result, bypass_unit_rules, lalr1, no_default_reductions>, checking>(inputs));
+    ALPHYN_CHECK(parses_like<parser<deep_math_eval, on_parse_error::return_result, bypass_unit_rules, no_default_reductions>, deep_keep>(inputs));
+    ALPHYN_CHECK(rejecting_states_are_right<keep>(inputs));
+    ALPHYN_CHECK(rejecting_states_are_right<checking>(inputs));
+    ALPHYN_CHECK(rejecting_states_are_right<parser<math_eval, on_parse_error::return_result, bypass_unit_rules, lalr1>>(inputs));
+    ALPHYN_CHECK(rejecting_states_are_right<parser<deep_math_eval, on_parse_error::return_result, bypass_unit_rules>>(inputs));
+
+    // without default reductions, "1 2" fails as soon as 1 is reduced to val (after the number, the follow set is checked)
+    ALPHYN_CHECK(keep::parse_string<long>("1 2").get_error().state != checking::parse_string<long>("1 2").get_error().state);
+    ALPHYN_CHECK(keep::parse_string<long>("1 2").get_error().offset == checking::parse_string<long>("1 2").get_error().offset);
+
+    // also at compile-time
+    static_assert(parser<math_eval, on_parse_error::return_result, bypass_unit_rules>::parse_string<long>("2 * (3 + 4)").get_value() == 14, "bypass_unit_rules at compile-time");
+  }
+
+  // the states with a default reduction
+  {
+    const std::vector<bool> canonical = default_reduction_states<parser<math_eval, on_parse_error::return_result>>::get();
+    const std::vector<bool> merged = default_reduction_states<parser<math_eval, on_parse_error::return_result, lalr1>>::get();
+    ALPHYN_CHECK(canonical.size() == 31 && std::count(canonical.begin(), canonical.end(), true) == 10);
+    ALPHYN_CHECK(merged.size() == 17 && std::count(merged.begin(), merged.end(), true) == 5);
+    ALPHYN_CHECK(!canonical[0]); // the initial state shifts
+  }
+
+  // the reductions that are skipped
+  {
+    // math_eval: only prod -> val is skipped (one reduction per number): for a list of additions, that's a third of the reductions
+    // (the others do something: val -> number, sum -> sum + prod, start -> sum end, and sum -> prod has to check the next token)
+    using keep = parser<math_eval, on_parse_error::return_result, collect_statistics>;
+    using bypass = parser<math_eval, on_parse_error::return_result, collect_statistics, bypass_unit_rules>;
+    using bypass_lalr = parser<math_eval, on_parse_error::return_result, collect_statistics, bypass_unit_rules, lalr1>;
+    ALPHYN_CHECK(reduction_count<keep>("1 + 2") == 7 && reduction_count<bypass>("1 + 2") == 5);
+    ALPHYN_CHECK(reduction_count<keep>("1+2+3+4+5+6") == 19 && reduction_count<bypass>("1+2+3+4+5+6") == 13);
+    ALPHYN_CHECK(reduction_count<bypass_lalr>("1+2+3+4+5+6") == 13);
+    ALPHYN_CHECK(reduction_count<keep>("((((1))))") == 16 && reduction_count<bypass>("((((1))))") == 11);
+
+    // with longer chains of unit rules, the reductions are cut by more than half (prod -> unary -> power -> val are all skipped)
+    using deep_keep = parser<deep_math_eval, on_parse_error::return_result, collect_statistics>;
+    using deep_bypass = parser<deep_math_eval, on_parse_error::return_result, collect_statistics, bypass_unit_rules>;
+    ALPHYN_CHECK(reduction_count<deep_keep>("1+2+3+4+5+6") == 31 && reduction_count<deep_bypass>("1+2+3+4+5+6") == 13);
+    ALPHYN_CHECK(reduction_count<deep_bypass>("1 * 2 + 3 * 4") * 2 < reduction_count<deep_keep>("1 * 2 + 3 * 4"));
+  }
+}
+
+#endif /*__N_2551783946120853_1640297531822__TEST_UNIT_RULES_HPP__*/
@@ -0,0 +1,200 @@
+//
+// file : test_user_context.hpp
+//
+// Copyright (c) 2016 Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __N_2877017042209259_1451520295137__TEST_USER_CONTEXT_HPP__
+# define __N_2877017042209259_1451520295137__TEST_USER_CONTEXT_HPP__
+
+#include <alphyn.hpp>
+
+#include "math_eval.hpp"
+#include "check.hpp"
+
+/// \brief The user context of context_math_eval: records the numbers and the operations it has seen (a literal type, to be usable at compile-time)
+struct recording_context
+{
+  long scale = 1;
+  long numbers[16] = {0};
+  size_t number_count = 0;
+  char operations[16] = {0};
+  size_t operation_count = 0;
+
+  constexpr void record_operation(char op)
+  {
+    if (operation_count < 16)
+      operations[operation_count] = op;
+    ++operation_count;
+  }
+};
+
+/// \brief math_eval, but the numbers are scaled by (and recorded in) the user context, and the operations are recorded in it
+struct context_math_eval : public math_eval
+{
+  using context_type = recording_context;
+
+  using lexer = neam::ct::alphyn::lexer<context_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<context_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<context_math_eval, Name, Rules...>;
+
+  static constexpr return_type attr_number(recording_context &rc, const token_type &number)
+  {
+    if (rc.number_count < 16)
+      rc.numbers[rc.number_count] = number.value;
+    ++rc.number_count;
+    return number.value * rc.scale;
+  }
+  static constexpr return_type attr_add(recording_context &rc, return_type n1, const token_type &, return_type n2) { rc.record_operation('+'); return n1 + n2; }
+  static constexpr return_type attr_sub(recording_context &rc, return_type n1, const token_type &, return_type n2) { rc.record_operation('-'); return n1 - n2; }
+  // a const context can be requested too (but then, nothing can be recorded)
+  static constexpr return_type attr_mul(const recording_context &rc, return_type n1, const token_type &, return_type n2) { return n1 * n2 / rc.scale; }
+
+  using grammar = neam::ct::alphyn::grammar<context_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&math_eval::attr_div), prod, tok_div, val>   // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_number), tok_number>,                                // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<context_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief The same, but the operations also request the arena (before or after the user context)
+struct context_arena_math_eval : public context_math_eval
+{
+  using lexer = neam::ct::alphyn::lexer<context_arena_math_eval>;
+
+  template<typename Attribute, type_t... TokensOrRules>
+  using production_rule = neam::ct::alphyn::production_rule<context_arena_math_eval, Attribute, TokensOrRules...>;
+  template<type_t Name, typename... Rules>
+  using production_rule_set = neam::ct::alphyn::production_rule_set<context_arena_math_eval, Name, Rules...>;
+
+  static return_type attr_add(neam::ct::alphyn::arena &a, recording_context &rc, return_type n1, const token_type &, return_type n2)
+  {
+    *a.make<char>() = '+';
+    rc.record_operation('+');
+    return n1 + n2;
+  }
+  static return_type attr_sub(recording_context &rc, neam::ct::alphyn::arena &a, return_type n1, const token_type &, return_type n2)
+  {
+    *a.make<char>() = '-';
+    rc.record_operation('-');
+    return n1 - n2;
+  }
+
+  using grammar = neam::ct::alphyn::grammar<context_arena_math_eval, start,
+    production_rule_set<start,
+      production_rule<neam::ct::alphyn::forward_first_attribute, sum, tok_end>      // start -> sum
+    >,
+    production_rule_set<sum,
+      production_rule<neam::ct::alphyn::forward_first_attribute, prod>,             // sum -> prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_add), sum, tok_add, prod>,             // sum -> sum + prod
+      production_rule<ALPHYN_ATTRIBUTE(&attr_sub), sum, tok_sub, prod>              // sum -> sum - prod
+    >,
+    production_rule_set<prod,
+      production_rule<neam::ct::alphyn::forward_first_attribute, val>,              // prod -> val
+      production_rule<ALPHYN_ATTRIBUTE(&attr_mul), prod, tok_mul, val>,             // prod -> prod * val
+      production_rule<ALPHYN_ATTRIBUTE(&math_eval::attr_div), prod, tok_div, val>   // prod -> prod / val
+    >,
+    production_rule_set<val,
+      production_rule<ALPHYN_ATTRIBUTE(&attr_number), tok_number>,                                // val -> number
+      production_rule<neam::ct::alphyn::forward_attribute<1>, tok_par_open, sum, tok_par_close>   // val -> ( sum )
+    >
+  >;
+
+  using parser = neam::ct::alphyn::parser<context_arena_math_eval, neam::ct::alphyn::on_parse_error::return_result>;
+};
+
+/// \brief Parse \p str at compile-time with a user context that scales the numbers by \p scale, and return what has been recorded in it
+constexpr recording_context parse_with_recording_context(const char *str, long scale)
+{
+  recording_context rc;
+  rc.scale = scale;
+  rc.numbers[15] = context_math_eval::parser::parse_string<long>(rc, str).get_value(); // the result, where the test can see it
+  return rc;
+}
+
+/// \brief The user context (SyntaxClass::context_type) given to the attributes
+inline void test_user_context()
+{
+  // at compile-time
+  static_assert(parse_with_recording_context("1 + 2 * 3 - 4", 1).numbers[15] == 3, "the user context works at compile-time");
+  static_assert(parse_with_recording_context("1 + 2 * 3 - 4", 10).numbers[15] == 30, "the user context works at compile-time");
+  static_assert(parse_with_recording_context("1 + 2 * 3 - 4", 1).number_count == 4, "the attributes record in the user context");
+  static_assert(parse_with_recording_context("1 + 2 * 3 - 4", 1).numbers[2] == 3, "the attributes record in the user context");
+  static_assert(parse_with_recording_context("1 + 2 * 3 - 4", 1).operations[1] == '-', "the attributes record in the user context");
+
+  // parse_string(user_context, str)
+  {
+    recording_context rc;
+    rc.scale = 2;
+    const auto result = context_math_eval::parser::parse_string<long>(rc, "(1 + 2) * 3 - 4 / 2");
+    ALPHYN_CHECK(result.has_value() && result.get_value() == 16); // (2 + 4) * 6 / 2 - 8 / 4, with the numbers scaled by 2
+    ALPHYN_CHECK(rc.number_count == 5 && rc.numbers[0] == 1 && rc.numbers[4] == 2);
+    ALPHYN_CHECK(rc.operation_count == 2 && rc.operations[0] == '+' && rc.operations[1] == '-');
+
+    // the attributes called before an error have recorded their things
+    recording_context rc_error;
+    ALPHYN_CHECK(!context_math_eval::parser::parse_string<long>(rc_error, "1 + 2 3").has_value());
+    ALPHYN_CHECK(rc_error.number_count == 2 && rc_error.operation_count == 0);
+  }
+
+  // parse_string(ctx, user_context, str): the context is re-used, but each parse has its own user context
+  {
+    context_math_eval::parser::context ctx;
+    recording_context first;
+    recording_context second;
+    second.scale = 3;
+    ALPHYN_CHECK(context_math_eval::parser::parse_string<long>(ctx, first, "1 + 1").get_value() == 2);
+    ALPHYN_CHECK(context_math_eval::parser::parse_string<long>(ctx, second, "1 + 1 + 1").get_value() == 9);
+    ALPHYN_CHECK(first.number_count == 2 && first.operation_count == 1);
+    ALPHYN_CHECK(second.number_count == 3 && second.operation_count == 2);
+  }
+
+  // the arena and the user context, requested by the same attributes
+  {
+    context_arena_math_eval::parser::context ctx;
+    recording_context rc;
+    const auto result = context_arena_math_eval::parser::parse_string<long>(ctx, rc, "8 - 2 + 1 - 4");
+    ALPHYN_CHECK(result.has_value() && result.get_value() == 3);
+    ALPHYN_CHECK(rc.number_count == 4 && rc.operation_count == 3);
+    ALPHYN_CHECK(rc.operations[0] == '-' && rc.operations[1] == '+' && rc.operations[2] == '-');
+  }
+}
+
+#endif /*__N_2877017042209259_1451520295137__TEST_USER_CONTEXT_HPP__*/